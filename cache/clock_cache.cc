@@ -1485,7 +1485,9 @@ std::shared_ptr<Cache> HyperClockCacheOptions::MakeSharedCache() const {
       capacity, estimated_entry_charge, my_num_shard_bits,
       strict_capacity_limit, metadata_charge_policy, memory_allocator);
   if (secondary_cache) {
-    cache = std::make_shared<CacheWithSecondaryAdapter>(cache, secondary_cache);
+    cache = std::make_shared<CacheWithSecondaryAdapter>(
+        cache, secondary_cache, adaptive_secondary_cache_capacity,
+        secondary_cache_miss_cost_nanos);
   }
   return cache;
 }
@@ -727,6 +727,51 @@ class CompressedSecondaryCacheTestBase : public testing::Test,
 
     sec_cache->GetHelper(true)->del_cb(chunks_head, /*alloc*/ nullptr);
   }
+
+  // Reads num_keys blocks of 1000 bytes in a loop, inserting the blocks that
+  // miss both caches, and returns the capacities of the two caches.
+  void AdaptiveCapacityTestHelper(int num_keys, uint64_t miss_cost_nanos,
+                                  size_t* primary_capacity,
+                                  size_t* secondary_capacity) {
+    const size_t kCapacity = 100 * 1000;
+    CompressedSecondaryCacheOptions secondary_cache_opts;
+    secondary_cache_opts.compression_type = CompressionType::kNoCompression;
+    secondary_cache_opts.capacity = kCapacity;
+    secondary_cache_opts.num_shard_bits = 0;
+    std::shared_ptr<SecondaryCache> secondary_cache =
+        NewCompressedSecondaryCache(secondary_cache_opts);
+    std::shared_ptr<Cache> cache =
+        NewCache(kCapacity, [=](ShardedCacheOptions& opts) {
+          opts.num_shard_bits = 0;
+          opts.metadata_charge_policy = kDontChargeCacheMetadata;
+          opts.secondary_cache = secondary_cache;
+          opts.adaptive_secondary_cache_capacity = true;
+          opts.secondary_cache_miss_cost_nanos = miss_cost_nanos;
+        });
+
+    Random rnd(301);
+    const std::string str = rnd.RandomString(1000);
+    for (int round = 0; round < 200; ++round) {
+      for (int i = 0; i < num_keys; ++i) {
+        char key[24];
+        snprintf(key, sizeof(key), "____    ____%04d", i);
+        Cache::Handle* handle =
+            cache->Lookup(key, GetHelper(), this, Cache::Priority::LOW);
+        if (handle != nullptr) {
+          cache->Release(handle);
+        } else {
+          auto item = new TestItem(str.data(), str.length());
+          ASSERT_OK(cache->Insert(key, item, GetHelper(), str.length()));
+        }
+      }
+    }
+
+    *primary_capacity = cache->GetCapacity();
+    ASSERT_OK(secondary_cache->GetCapacity(*secondary_capacity));
+    ASSERT_EQ(2 * kCapacity, *primary_capacity + *secondary_capacity);
+    ASSERT_GE(*primary_capacity, 2 * kCapacity / 10);
+    ASSERT_GE(*secondary_capacity, 2 * kCapacity / 10);
+  }
 };
 
 class CompressedSecondaryCacheTest
@@ -971,6 +1016,22 @@ TEST_P(CompressedSecondaryCacheTest, SplictValueAndMergeChunksTest) {
   SplictValueAndMergeChunksTest();
 }
 
+TEST_P(CompressedSecondaryCacheTest, AdaptiveCapacity) {
+  size_t primary_capacity = 0;
+  size_t secondary_capacity = 0;
+  // The working set does not fit in the two caches and misses are expensive,
+  // so capacity moves to the secondary cache.
+  AdaptiveCapacityTestHelper(/*num_keys=*/400, /*miss_cost_nanos=*/1000000000,
+                             &primary_capacity, &secondary_capacity);
+  ASSERT_GT(secondary_capacity, primary_capacity);
+
+  // The working set fits in the two caches but not in the primary cache, and
+  // misses are free, so capacity moves to the primary cache.
+  AdaptiveCapacityTestHelper(/*num_keys=*/150, /*miss_cost_nanos=*/0,
+                             &primary_capacity, &secondary_capacity);
+  ASSERT_GT(primary_capacity, secondary_capacity);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -712,7 +712,8 @@ std::shared_ptr<Cache> NewLRUCache(
     std::shared_ptr<MemoryAllocator> memory_allocator, bool use_adaptive_mutex,
     CacheMetadataChargePolicy metadata_charge_policy,
     const std::shared_ptr<SecondaryCache>& secondary_cache,
-    double low_pri_pool_ratio) {
+    double low_pri_pool_ratio, bool adaptive_secondary_cache_capacity,
+    uint64_t secondary_cache_miss_cost_nanos) {
   if (num_shard_bits >= 20) {
     return nullptr;  // The cache cannot be sharded into too many fine pieces.
   }
@@ -736,7 +737,9 @@ std::shared_ptr<Cache> NewLRUCache(
       low_pri_pool_ratio, std::move(memory_allocator), use_adaptive_mutex,
       metadata_charge_policy);
   if (secondary_cache) {
-    cache = std::make_shared<CacheWithSecondaryAdapter>(cache, secondary_cache);
+    cache = std::make_shared<CacheWithSecondaryAdapter>(
+        cache, secondary_cache, adaptive_secondary_cache_capacity,
+        secondary_cache_miss_cost_nanos);
   }
   return cache;
 }
@@ -747,7 +750,9 @@ std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts) {
                      cache_opts.high_pri_pool_ratio,
                      cache_opts.memory_allocator, cache_opts.use_adaptive_mutex,
                      cache_opts.metadata_charge_policy,
-                     cache_opts.secondary_cache, cache_opts.low_pri_pool_ratio);
+                     cache_opts.secondary_cache, cache_opts.low_pri_pool_ratio,
+                     cache_opts.adaptive_secondary_cache_capacity,
+                     cache_opts.secondary_cache_miss_cost_nanos);
 }
 
 std::shared_ptr<Cache> NewLRUCache(
@@ -758,6 +763,8 @@ std::shared_ptr<Cache> NewLRUCache(
     double low_pri_pool_ratio) {
   return NewLRUCache(capacity, num_shard_bits, strict_capacity_limit,
                      high_pri_pool_ratio, memory_allocator, use_adaptive_mutex,
-                     metadata_charge_policy, nullptr, low_pri_pool_ratio);
+                     metadata_charge_policy, nullptr, low_pri_pool_ratio,
+                     /*adaptive_secondary_cache_capacity=*/false,
+                     /*secondary_cache_miss_cost_nanos=*/0);
 }
 }  // namespace ROCKSDB_NAMESPACE
@@ -6,6 +6,7 @@
 #include "cache/secondary_cache_adapter.h"
 
 #include "monitoring/perf_context_imp.h"
+#include "rocksdb/system_clock.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -16,13 +17,29 @@ struct Dummy {
 };
 const Dummy kDummy{};
 Cache::ObjectPtr const kDummyObj = const_cast<Dummy*>(&kDummy);
+
+// Secondary cache lookups between two capacity adjustments
+constexpr uint64_t kAdjustCapacityInterval = 4096;
+// Each adjustment moves 1/kCapacityStepDivisor of the total capacity
+constexpr size_t kCapacityStepDivisor = 64;
+// Each cache keeps at least 1/kMinCapacityDivisor of the total capacity
+constexpr size_t kMinCapacityDivisor = 10;
+
+bool SecondaryCapacitySupported(SecondaryCache* secondary_cache) {
+  size_t capacity = 0;
+  return secondary_cache->GetCapacity(capacity).ok();
+}
 }  // namespace
 
 CacheWithSecondaryAdapter::CacheWithSecondaryAdapter(
     std::shared_ptr<Cache> target,
-    std::shared_ptr<SecondaryCache> secondary_cache)
+    std::shared_ptr<SecondaryCache> secondary_cache, bool adaptive_capacity,
+    uint64_t miss_cost_nanos)
     : CacheWrapper(std::move(target)),
-      secondary_cache_(std::move(secondary_cache)) {
+      secondary_cache_(std::move(secondary_cache)),
+      adaptive_capacity_(adaptive_capacity &&
+                         SecondaryCapacitySupported(secondary_cache_.get())),
+      miss_cost_nanos_(miss_cost_nanos) {
   target_->SetEvictionCallback([this](const Slice& key, Handle* handle) {
     return EvictionHandler(key, handle);
   });
@@ -152,9 +169,16 @@ Cache::Handle* CacheWithSecondaryAdapter::Lookup(const Slice& key,
   if (!result && secondary_compatible) {
     // Try our secondary cache
     bool kept_in_sec_cache = false;
+    const uint64_t start_nanos =
+        adaptive_capacity_ ? SystemClock::Default()->NowNanos() : 0;
     std::unique_ptr<SecondaryCacheResultHandle> secondary_handle =
         secondary_cache_->Lookup(key, helper, create_context, /*wait*/ true,
                                  found_dummy_entry, /*out*/ kept_in_sec_cache);
+    if (adaptive_capacity_) {
+      const bool hit = secondary_handle && secondary_handle->Value();
+      RecordSecondaryLookup(
+          hit, hit ? SystemClock::Default()->NowNanos() - start_nanos : 0);
+    }
     if (secondary_handle) {
       result = Promote(std::move(secondary_handle), key, helper, priority,
                        stats, found_dummy_entry, kept_in_sec_cache);
@@ -184,6 +208,8 @@ void CacheWithSecondaryAdapter::StartAsyncLookupOnMySecondary(
     // TODO with stacked secondaries: Check & process if already ready?
     async_handle.pending_handle = secondary_handle.release();
     async_handle.pending_cache = secondary_cache_.get();
+  } else if (adaptive_capacity_) {
+    RecordSecondaryLookup(/*hit=*/false, /*hit_nanos=*/0);
   }
 }
 
@@ -274,6 +300,11 @@ void CacheWithSecondaryAdapter::WaitAll(AsyncLookupHandle* async_handles,
     std::unique_ptr<SecondaryCacheResultHandle> secondary_handle(
         cur->pending_handle);
     cur->pending_handle = nullptr;
+    if (adaptive_capacity_) {
+      // The time of the asynchronous lookups overlaps, so only count them
+      RecordSecondaryLookup(secondary_handle->Value() != nullptr,
+                            /*hit_nanos=*/0);
+    }
     cur->result_handle = Promote(
         std::move(secondary_handle), cur->key, cur->helper, cur->priority,
         cur->stats, cur->found_dummy_entry, cur->kept_in_sec_cache);
@@ -281,6 +312,83 @@ void CacheWithSecondaryAdapter::WaitAll(AsyncLookupHandle* async_handles,
   }
 }
 
+void CacheWithSecondaryAdapter::RecordSecondaryLookup(bool hit,
+                                                      uint64_t hit_nanos) {
+  if (hit) {
+    secondary_hits_.fetch_add(1, std::memory_order_relaxed);
+    if (hit_nanos > 0) {
+      timed_secondary_hits_.fetch_add(1, std::memory_order_relaxed);
+      secondary_hit_nanos_.fetch_add(hit_nanos, std::memory_order_relaxed);
+    }
+  }
+  if (secondary_lookups_.fetch_add(1, std::memory_order_relaxed) + 1 >=
+      kAdjustCapacityInterval) {
+    AdjustCapacity();
+  }
+}
+
+void CacheWithSecondaryAdapter::AdjustCapacity() {
+  std::unique_lock<std::mutex> lock(adjust_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    // Another thread is adjusting the capacity
+    return;
+  }
+  const uint64_t lookups =
+      secondary_lookups_.exchange(0, std::memory_order_relaxed);
+  if (lookups < kAdjustCapacityInterval) {
+    // Another thread has just adjusted the capacity
+    secondary_lookups_.fetch_add(lookups, std::memory_order_relaxed);
+    return;
+  }
+  const uint64_t hits = std::min(
+      secondary_hits_.exchange(0, std::memory_order_relaxed), lookups);
+  const uint64_t timed_hits =
+      timed_secondary_hits_.exchange(0, std::memory_order_relaxed);
+  const uint64_t hit_nanos =
+      secondary_hit_nanos_.exchange(0, std::memory_order_relaxed);
+  if (hits > 0 && timed_hits == 0) {
+    // No estimate of the cost of a hit
+    return;
+  }
+
+  // The time spent in secondary cache hits (mostly decompressing) against
+  // the estimated cost of the misses. Giving capacity to the secondary cache
+  // keeps more blocks in the same memory and turns misses into hits, while
+  // giving it to the primary cache turns hits into primary cache hits.
+  const uint64_t hit_cost = hits == 0 ? 0 : hit_nanos / timed_hits * hits;
+  const uint64_t miss_cost = (lookups - hits) * miss_cost_nanos_;
+  if (hit_cost == miss_cost) {
+    return;
+  }
+
+  size_t secondary_capacity = 0;
+  if (!secondary_cache_->GetCapacity(secondary_capacity).ok()) {
+    return;
+  }
+  const size_t primary_capacity = target_->GetCapacity();
+  const size_t total_capacity = primary_capacity + secondary_capacity;
+  const size_t min_capacity = total_capacity / kMinCapacityDivisor;
+  const size_t step = total_capacity / kCapacityStepDivisor;
+  // Shrink before growing so the sum never exceeds the total capacity
+  if (miss_cost > hit_cost) {
+    if (primary_capacity <= min_capacity) {
+      return;
+    }
+    const size_t delta = std::min(step, primary_capacity - min_capacity);
+    target_->SetCapacity(primary_capacity - delta);
+    secondary_cache_->SetCapacity(secondary_capacity + delta)
+        .PermitUncheckedError();
+  } else {
+    if (secondary_capacity <= min_capacity) {
+      return;
+    }
+    const size_t delta = std::min(step, secondary_capacity - min_capacity);
+    secondary_cache_->SetCapacity(secondary_capacity - delta)
+        .PermitUncheckedError();
+    target_->SetCapacity(primary_capacity + delta);
+  }
+}
+
 std::string CacheWithSecondaryAdapter::GetPrintableOptions() const {
   std::string str = target_->GetPrintableOptions();
   str.append("  secondary_cache:\n");
@@ -5,15 +5,21 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
 #include "rocksdb/secondary_cache.h"
 
 namespace ROCKSDB_NAMESPACE {
 
 class CacheWithSecondaryAdapter : public CacheWrapper {
  public:
+  // See ShardedCacheOptions::adaptive_secondary_cache_capacity and
+  // secondary_cache_miss_cost_nanos
   explicit CacheWithSecondaryAdapter(
       std::shared_ptr<Cache> target,
-      std::shared_ptr<SecondaryCache> secondary_cache);
+      std::shared_ptr<SecondaryCache> secondary_cache,
+      bool adaptive_capacity = false, uint64_t miss_cost_nanos = 0);
 
   ~CacheWithSecondaryAdapter() override;
 
@@ -46,7 +52,24 @@ class CacheWithSecondaryAdapter : public CacheWrapper {
 
   void CleanupCacheObject(ObjectPtr obj, const CacheItemHelper* helper);
 
+  // Accounts for a lookup in the secondary cache and rebalances the
+  // capacities every kAdjustCapacityInterval such lookups. hit_nanos is the
+  // time spent in a hit, or 0 if it was not measured.
+  void RecordSecondaryLookup(bool hit, uint64_t hit_nanos);
+
+  void AdjustCapacity();
+
   std::shared_ptr<SecondaryCache> secondary_cache_;
+
+  // Adaptive capacity state, see ShardedCacheOptions
+  const bool adaptive_capacity_;
+  const uint64_t miss_cost_nanos_;
+  std::atomic<uint64_t> secondary_lookups_{0};
+  std::atomic<uint64_t> secondary_hits_{0};
+  // Hits whose time was measured (synchronous lookups), and that time
+  std::atomic<uint64_t> timed_secondary_hits_{0};
+  std::atomic<uint64_t> secondary_hit_nanos_{0};
+  std::mutex adjust_mutex_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -229,6 +229,58 @@ TEST_F(DBBlobBasicTest, IterateBlobsFromCache) {
   }
 }
 
+TEST_F(DBBlobBasicTest, IterateBlobsWithReadahead) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+
+  Reopen(options);
+
+  constexpr int num_blobs = 16;
+  std::vector<std::string> keys;
+  std::vector<std::string> blobs;
+
+  for (int i = 0; i < num_blobs; ++i) {
+    keys.push_back("key" + std::to_string(i + 10));
+    blobs.push_back(std::string(100, static_cast<char>('a' + i)));
+    ASSERT_OK(Put(keys[i], blobs[i]));
+  }
+  ASSERT_OK(Flush());
+
+  size_t num_non_prefetch_reads = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobFileReader::GetBlob:ReadFromFile",
+      [&num_non_prefetch_reads](void* /* arg */) { ++num_non_prefetch_reads; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  auto scan = [&](size_t blob_readahead_size) {
+    ReadOptions read_options;
+    read_options.fill_cache = false;
+    read_options.blob_readahead_size = blob_readahead_size;
+
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+
+    int i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_EQ(iter->key().ToString(), keys[i]);
+      ASSERT_EQ(iter->value().ToString(), blobs[i]);
+      ++i;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(i, num_blobs);
+  };
+
+  scan(0);
+  ASSERT_EQ(num_non_prefetch_reads, static_cast<size_t>(num_blobs));
+
+  num_non_prefetch_reads = 0;
+  scan(1 << 20);
+  ASSERT_EQ(num_non_prefetch_reads, 0);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBBlobBasicTest, IterateBlobsFromCachePinning) {
   constexpr size_t min_blob_size = 6;
 
@@ -1882,6 +1882,9 @@ Status CompactionJob::OpenCompactionOutputFile(SubcompactionState* sub_compact,
       bottommost_level_, TableFileCreationReason::kCompaction,
       0 /* oldest_key_time */, current_time, db_id_, db_session_id_,
       sub_compact->compaction->max_output_file_size(), file_number);
+  if (tboptions.compression_opts.reuse_dict_across_files) {
+    tboptions.shared_compression_dict = outputs.shared_compression_dict();
+  }
 
   outputs.NewBuilder(tboptions);
 
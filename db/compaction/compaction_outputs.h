@@ -58,6 +58,9 @@ class CompactionOutputs {
   // Set new table builder for the current output
   void NewBuilder(const TableBuilderOptions& tboptions);
 
+  // Compression dictionary reused by all the output files of this level
+  std::string* shared_compression_dict() { return &shared_compression_dict_; }
+
   // Assign a new WritableFileWriter to the current output
   void AssignFileWriter(WritableFileWriter* writer) {
     file_writer_.reset(writer);
@@ -300,6 +303,10 @@ class CompactionOutputs {
   std::unique_ptr<WritableFileWriter> file_writer_;
   uint64_t current_output_file_size_ = 0;
 
+  // Dictionary built for the first output file, see
+  // CompressionOptions::reuse_dict_across_files
+  std::string shared_compression_dict_;
+
   // all the compaction outputs so far
   std::vector<Output> outputs_;
 
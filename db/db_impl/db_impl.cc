@@ -61,10 +61,13 @@
 #include "logging/auto_roll_logger.h"
 #include "logging/log_buffer.h"
 #include "logging/logging.h"
+#include "monitoring/cf_operation_stats.h"
 #include "monitoring/in_memory_stats_history.h"
 #include "monitoring/instrumented_mutex.h"
 #include "monitoring/iostats_context_imp.h"
 #include "monitoring/perf_context_imp.h"
+#include "monitoring/perf_context_sampler.h"
+#include "monitoring/slow_operation_tracker.h"
 #include "monitoring/persistent_stats_history.h"
 #include "monitoring/thread_status_updater.h"
 #include "monitoring/thread_status_util.h"
@@ -298,6 +301,12 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
   if (immutable_db_options_.use_spdb_writes) {
     spdb_write_.reset(new SpdbWriteImpl(this));
   }
+
+  if (immutable_db_options_.wal_compression != kNoCompression &&
+      immutable_db_options_.wal_compression_threads > 0) {
+    wal_compression_thread_pool_.reset(
+        NewThreadPool(immutable_db_options_.wal_compression_threads));
+  }
 }
 
 Status DBImpl::Resume() {
@@ -684,6 +693,10 @@ Status DBImpl::CloseHelper() {
     }
     logs_.clear();
   }
+  if (wal_compression_thread_pool_) {
+    // No WAL writer is left to use the pool
+    wal_compression_thread_pool_->JoinAllThreads();
+  }
 
   // Table cache may have table handles holding blocks from the block cache.
   // We need to release them before the block cache is destroyed. The block
@@ -948,20 +961,36 @@ void DBImpl::PersistStats() {
       ROCKS_LOG_INFO(immutable_db_options_.info_log,
                      "Reading %" ROCKSDB_PRIszt " stats from statistics\n",
                      stats_slice_.size());
+      std::map<std::string, uint64_t> stats_delta;
       for (const auto& stat : stats_map) {
-        if (s.ok()) {
-          char key[100];
-          int length =
-              EncodePersistentStatsKey(now_seconds, stat.first, 100, key);
-          // calculate the delta from last time
-          if (stats_slice_.find(stat.first) != stats_slice_.end()) {
-            uint64_t delta = stat.second - stats_slice_[stat.first];
-            s = batch.Put(persist_stats_cf_handle_,
-                          Slice(key, std::min(100, length)),
-                          std::to_string(delta));
-          }
+        // calculate the delta from last time
+        if (stats_slice_.find(stat.first) != stats_slice_.end()) {
+          stats_delta[stat.first] = stat.second - stats_slice_[stat.first];
         }
       }
+      // The percentiles of the histograms recorded so far
+      for (const auto& histogram : HistogramsNameMap) {
+        HistogramData data;
+        statistics->histogramData(histogram.first, &data);
+        if (data.count == 0) {
+          continue;
+        }
+        stats_delta[histogram.second + ".p50"] =
+            static_cast<uint64_t>(data.median);
+        stats_delta[histogram.second + ".p95"] =
+            static_cast<uint64_t>(data.percentile95);
+        stats_delta[histogram.second + ".p99"] =
+            static_cast<uint64_t>(data.percentile99);
+        stats_delta[histogram.second + ".max"] =
+            static_cast<uint64_t>(data.max);
+      }
+      if (!stats_block_builder_) {
+        stats_block_builder_.reset(new PersistentStatsBlockBuilder());
+      }
+      std::string key;
+      std::string value;
+      stats_block_builder_->Add(now_seconds, stats_delta, &key, &value);
+      s = batch.Put(persist_stats_cf_handle_, key, value);
     }
     stats_slice_initialized_ = true;
     std::swap(stats_slice_, stats_map);
@@ -1047,15 +1076,22 @@ bool DBImpl::FindStatsByTime(uint64_t start_time, uint64_t end_time,
 Status DBImpl::GetStatsHistory(
     uint64_t start_time, uint64_t end_time,
     std::unique_ptr<StatsHistoryIterator>* stats_iterator) {
+  return GetStatsHistory(start_time, end_time, {}, stats_iterator);
+}
+
+Status DBImpl::GetStatsHistory(
+    uint64_t start_time, uint64_t end_time,
+    const std::vector<std::string>& stat_names,
+    std::unique_ptr<StatsHistoryIterator>* stats_iterator) {
   if (!stats_iterator) {
     return Status::InvalidArgument("stats_iterator not preallocated.");
   }
   if (immutable_db_options_.persist_stats_to_disk) {
-    stats_iterator->reset(
-        new PersistentStatsHistoryIterator(start_time, end_time, this));
+    stats_iterator->reset(new PersistentStatsHistoryIterator(
+        start_time, end_time, this, stat_names));
   } else {
-    stats_iterator->reset(
-        new InMemoryStatsHistoryIterator(start_time, end_time, this));
+    stats_iterator->reset(new InMemoryStatsHistoryIterator(
+        start_time, end_time, this, stat_names));
   }
   return (*stats_iterator)->status();
 }
@@ -2134,6 +2170,14 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
   auto cfh = static_cast_with_check<ColumnFamilyHandleImpl>(
       get_impl_options.column_family);
   auto cfd = cfh->cfd();
+  CFOperationTimer cf_op_timer(immutable_db_options_.clock,
+                               cfd->internal_stats()->GetCFOperationStats(),
+                               CFOperationStats::kGet);
+  PerfContextSampleGuard perf_sample(
+      immutable_db_options_.clock,
+      cfd->internal_stats()->GetPerfContextSampler(), PerfContextSampler::kGet);
+  SlowOperationTracker slow_op_tracker(
+      &immutable_db_options_, SlowOperationType::kGet, &cfd->GetName());
 
   if (tracer_) {
     // TODO: This mutex should be removed later, to improve performance when
@@ -2404,6 +2448,34 @@ std::vector<Status> DBImpl::MultiGet(
   PERF_CPU_TIMER_GUARD(get_cpu_nanos, immutable_db_options_.clock);
   StopWatch sw(immutable_db_options_.clock, stats_, DB_MULTIGET);
   PERF_TIMER_GUARD(get_snapshot_time);
+  // The latency of the whole call is recorded for each column family
+  const uint64_t start_micros = immutable_db_options_.enable_cf_latency_stats
+                                    ? immutable_db_options_.clock->NowMicros()
+                                    : 0;
+  // A sampled call is attributed to the column family of its first key
+  PerfContextSampleGuard perf_sample(
+      immutable_db_options_.clock,
+      keys.empty() ? nullptr
+                   : static_cast_with_check<ColumnFamilyHandleImpl>(
+                         column_family[0])
+                         ->cfd()
+                         ->internal_stats()
+                         ->GetPerfContextSampler(),
+      PerfContextSampler::kMultiGet);
+  // A slow call is only attributed to a column family if all its keys are
+  // on it
+  const std::string* slow_op_cf_name = nullptr;
+  if (immutable_db_options_.slow_operation_threshold_micros > 0 &&
+      !keys.empty() &&
+      std::all_of(column_family.begin(), column_family.end(),
+                  [&](ColumnFamilyHandle* cfh) {
+                    return cfh == column_family[0];
+                  })) {
+    slow_op_cf_name = &column_family[0]->GetName();
+  }
+  SlowOperationTracker slow_op_tracker(&immutable_db_options_,
+                                       SlowOperationType::kMultiGet,
+                                       slow_op_cf_name);
 
   size_t num_keys = keys.size();
   assert(column_family.size() == num_keys);
@@ -2582,6 +2654,13 @@ std::vector<Status> DBImpl::MultiGet(
 
   for (auto mgd_iter : multiget_cf_data) {
     auto mgd = mgd_iter.second;
+    CFOperationStats* cf_op_stats =
+        mgd.cfd->internal_stats()->GetCFOperationStats();
+    if (cf_op_stats != nullptr) {
+      cf_op_stats->RecordLatency(
+          CFOperationStats::kMultiGet,
+          immutable_db_options_.clock->NowMicros() - start_micros);
+    }
     if (!unref_only) {
       ReturnAndCleanupSuperVersion(mgd.cfd, mgd.super_version);
     } else {
@@ -3057,6 +3136,17 @@ Status DBImpl::MultiGetImpl(
     ReadCallback* callback) {
   PERF_CPU_TIMER_GUARD(get_cpu_nanos, immutable_db_options_.clock);
   StopWatch sw(immutable_db_options_.clock, stats_, DB_MULTIGET);
+  CFOperationTimer cf_op_timer(
+      immutable_db_options_.clock,
+      super_version->cfd->internal_stats()->GetCFOperationStats(),
+      CFOperationStats::kMultiGet);
+  PerfContextSampleGuard perf_sample(
+      immutable_db_options_.clock,
+      super_version->cfd->internal_stats()->GetPerfContextSampler(),
+      PerfContextSampler::kMultiGet);
+  SlowOperationTracker slow_op_tracker(&immutable_db_options_,
+                                       SlowOperationType::kMultiGet,
+                                       &super_version->cfd->GetName());
 
   assert(sorted_keys);
   // Clear the timestamps for returning results so that we can distinguish
@@ -5422,6 +5512,7 @@ Status DBImpl::IngestExternalFiles(
     if (two_write_queues_) {
       nonmem_write_thread_.EnterUnbatched(&nonmem_w, &mutex_);
     }
+    const uint64_t write_stop_start = immutable_db_options_.clock->NowMicros();
 
     // When unordered_write is enabled, the keys are writing to memtable in an
     // unordered way. If the ingestion job checks memtable key range before the
@@ -5580,6 +5671,8 @@ Status DBImpl::IngestExternalFiles(
     }
 
     // Resume writes to the DB
+    const uint64_t write_stop_micros =
+        immutable_db_options_.clock->NowMicros() - write_stop_start;
     if (two_write_queues_) {
       nonmem_write_thread_.ExitUnbatched(&nonmem_w);
     }
@@ -5587,7 +5680,7 @@ Status DBImpl::IngestExternalFiles(
 
     if (status.ok()) {
       for (auto& job : ingestion_jobs) {
-        job.UpdateStats();
+        job.UpdateStats(write_stop_micros);
       }
     }
     ReleaseFileNumberFromPendingOutputs(pending_output_elem);
@@ -55,6 +55,7 @@
 #include "rocksdb/env.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/status.h"
+#include "rocksdb/threadpool.h"
 #include "rocksdb/trace_reader_writer.h"
 #include "rocksdb/transaction_log.h"
 #include "rocksdb/utilities/replayer.h"
@@ -74,6 +75,7 @@ class Arena;
 class ArenaWrappedDBIter;
 class InMemoryStatsHistoryIterator;
 class MemTable;
+class PersistentStatsBlockBuilder;
 class PersistentStatsHistoryIterator;
 class TableCache;
 class TaskLimiterToken;
@@ -486,6 +488,11 @@ class DBImpl : public DB {
       uint64_t start_time, uint64_t end_time,
       std::unique_ptr<StatsHistoryIterator>* stats_iterator) override;
 
+  Status GetStatsHistory(
+      uint64_t start_time, uint64_t end_time,
+      const std::vector<std::string>& stat_names,
+      std::unique_ptr<StatsHistoryIterator>* stats_iterator) override;
+
   using DB::ResetStats;
   virtual Status ResetStats() override;
   // All the returned filenames start with "/"
@@ -2528,6 +2535,9 @@ class DBImpl : public DB {
 
   bool stats_slice_initialized_ = false;
 
+  // The stats block being filled when persist_stats_to_disk is set
+  std::unique_ptr<PersistentStatsBlockBuilder> stats_block_builder_;
+
   Directories directories_;
 
   WriteBufferManager* write_buffer_manager_;
@@ -2756,6 +2766,10 @@ class DBImpl : public DB {
   // Pointer to Speedb write flow
   std::unique_ptr<SpdbWriteImpl> spdb_write_;
 
+  // Helper threads compressing large WAL records, used when
+  // wal_compression_threads > 0
+  std::unique_ptr<ThreadPool> wal_compression_thread_pool_;
+
   // Pointer to WriteBufferManager stalling interface.
   std::unique_ptr<StallInterface> wbm_stall_;
 
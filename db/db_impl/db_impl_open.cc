@@ -7,6 +7,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include <cinttypes>
+#include <deque>
 
 #include "db/builder.h"
 #include "db/db_impl/db_impl.h"
@@ -23,6 +24,7 @@
 #include "rocksdb/table.h"
 #include "rocksdb/wal_filter.h"
 #include "test_util/sync_point.h"
+#include "util/mutexlock.h"
 #include "util/rate_limiter.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -236,6 +238,96 @@ Status ValidateOptionsByTable(
   }
   return Status::OK();
 }
+
+// Replay progress is logged every time this many bytes of a WAL were replayed
+constexpr uint64_t kWalRecoveryProgressInterval = uint64_t{1} << 30;
+
+// Reads the records of a WAL on a background thread, so that reading,
+// checksum verification and decompression overlap with the memtable inserts
+// done by the recovering thread. The reporter of "reader" must only be used
+// by this class and must record errors in "reader_status", if anywhere.
+class WalRecordPrefetcher {
+ public:
+  WalRecordPrefetcher(log::Reader* reader, WALRecoveryMode wal_recovery_mode,
+                      const Status* reader_status)
+      : reader_(reader),
+        wal_recovery_mode_(wal_recovery_mode),
+        reader_status_(reader_status),
+        cv_(&mutex_) {
+    thread_ = port::Thread(&WalRecordPrefetcher::Run, this);
+  }
+
+  ~WalRecordPrefetcher() { Stop(); }
+
+  // Returns the next record of the WAL, or false once all records were
+  // returned or reading stopped because of an error reported to the reporter.
+  bool Next(std::string* record, uint64_t* record_checksum) {
+    MutexLock l(&mutex_);
+    while (queue_.empty() && !done_) {
+      cv_.Wait();
+    }
+    if (queue_.empty()) {
+      return false;
+    }
+    *record = std::move(queue_.front().first);
+    *record_checksum = queue_.front().second;
+    queue_.pop_front();
+    queued_bytes_ -= record->size();
+    cv_.SignalAll();
+    return true;
+  }
+
+  // Stops reading and waits for the background thread to exit
+  void Stop() {
+    {
+      MutexLock l(&mutex_);
+      stopped_ = true;
+      cv_.SignalAll();
+    }
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+ private:
+  // Bounds the memory used by records read but not replayed yet
+  static constexpr size_t kMaxQueuedBytes = 64 << 20;
+
+  void Run() {
+    std::string scratch;
+    Slice record;
+    uint64_t record_checksum;
+    while (reader_->ReadRecord(&record, &scratch, wal_recovery_mode_,
+                               &record_checksum) &&
+           reader_status_->ok()) {
+      MutexLock l(&mutex_);
+      while (!stopped_ && !queue_.empty() &&
+             queued_bytes_ + record.size() > kMaxQueuedBytes) {
+        cv_.Wait();
+      }
+      if (stopped_) {
+        break;
+      }
+      queued_bytes_ += record.size();
+      queue_.emplace_back(record.ToString(), record_checksum);
+      cv_.SignalAll();
+    }
+    MutexLock l(&mutex_);
+    done_ = true;
+    cv_.SignalAll();
+  }
+
+  log::Reader* reader_;
+  const WALRecoveryMode wal_recovery_mode_;
+  const Status* reader_status_;
+  port::Thread thread_;
+  port::Mutex mutex_;
+  port::CondVar cv_;
+  std::deque<std::pair<std::string, uint64_t>> queue_;
+  size_t queued_bytes_ = 0;
+  bool stopped_ = false;
+  bool done_ = false;
+};
 }  // namespace
 
 Status DBImpl::ValidateOptions(
@@ -782,6 +874,14 @@ Status DBImpl::PersistentStatsProcessFormatVersion() {
         // should also persist version here because old stats CF is discarded
         should_persist_format_version = true;
       }
+    } else if (format_version_recovered < kStatsCFCurrentFormatVersion) {
+      // The snapshots of the older format are kept and still read, the new
+      // ones are persisted in the current format
+      ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                     "Upgrading persistent stats format version from %" PRIu64
+                     " to %" PRIu64,
+                     format_version_recovered, kStatsCFCurrentFormatVersion);
+      should_persist_format_version = true;
     }
   }
   if (should_persist_format_version) {
@@ -1086,12 +1186,22 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     } else {
       reporter.status = &status;
     }
+    // With pipelined recovery the log reader runs on its own thread, so it
+    // gets its own reporter and status. Errors that it reports are merged
+    // into status once the records read before them were replayed.
+    const bool pipelined = immutable_db_options_.enable_pipelined_wal_recovery;
+    Status reader_status;
+    LogReporter reader_reporter = reporter;
+    if (reporter.status != nullptr) {
+      reader_reporter.status = &reader_status;
+    }
     // We intentially make log::Reader do checksumming even if
     // paranoid_checks==false so that corruptions cause entire commits
     // to be skipped instead of propagating bad information (like overly
     // large sequence numbers).
     log::Reader reader(immutable_db_options_.info_log, std::move(file_reader),
-                       &reporter, true /*checksum*/, wal_number);
+                       pipelined ? &reader_reporter : &reporter,
+                       true /*checksum*/, wal_number);
 
     // Determine if we should tolerate incomplete records at the tail end of the
     // Read all the records and add to a memtable
@@ -1100,12 +1210,43 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
 
     TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:BeforeReadWal",
                              /*arg=*/nullptr);
+    std::unique_ptr<WalRecordPrefetcher> prefetcher;
+    if (pipelined) {
+      prefetcher.reset(new WalRecordPrefetcher(
+          &reader, immutable_db_options_.wal_recovery_mode, &reader_status));
+    }
+    auto read_record = [&](uint64_t* record_checksum) {
+      if (!pipelined) {
+        return reader.ReadRecord(&record, &scratch,
+                                 immutable_db_options_.wal_recovery_mode,
+                                 record_checksum);
+      }
+      if (prefetcher->Next(&scratch, record_checksum)) {
+        record = scratch;
+        return true;
+      }
+      if (status.ok()) {
+        status = reader_status;
+      }
+      return false;
+    };
+
+    const uint64_t replay_start_micros = immutable_db_options_.clock->NowMicros();
+    uint64_t replayed_records = 0;
+    uint64_t replayed_bytes = 0;
+    uint64_t next_progress_bytes = kWalRecoveryProgressInterval;
     uint64_t record_checksum;
-    while (!stop_replay_by_wal_filter &&
-           reader.ReadRecord(&record, &scratch,
-                             immutable_db_options_.wal_recovery_mode,
-                             &record_checksum) &&
+    while (!stop_replay_by_wal_filter && read_record(&record_checksum) &&
            status.ok()) {
+      ++replayed_records;
+      replayed_bytes += record.size();
+      if (replayed_bytes >= next_progress_bytes) {
+        next_progress_bytes += kWalRecoveryProgressInterval;
+        ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                       "Recovering log #%" PRIu64 ": replayed %" PRIu64
+                       " records, %" PRIu64 " MB so far",
+                       wal_number, replayed_records, replayed_bytes >> 20);
+      }
       if (record.size() < WriteBatchInternal::kHeader) {
         reporter.Corruption(record.size(),
                             Status::Corruption("log record too small"));
@@ -1201,6 +1342,23 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
         }
       }
     }
+    if (prefetcher) {
+      prefetcher->Stop();
+    }
+    {
+      const uint64_t replay_micros =
+          immutable_db_options_.clock->NowMicros() - replay_start_micros;
+      ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                     "Replayed log #%" PRIu64 ": %" PRIu64 " records, %" PRIu64
+                     " bytes in %.3f seconds (%.1f MB/s)%s",
+                     wal_number, replayed_records, replayed_bytes,
+                     replay_micros / 1000000.0,
+                     replay_micros == 0
+                         ? 0.0
+                         : static_cast<double>(replayed_bytes) /
+                               static_cast<double>(replay_micros),
+                     pipelined ? ", pipelined" : "");
+    }
 
     if (!status.ok()) {
       if (status.IsNotSupported()) {
@@ -1764,7 +1922,8 @@ IOStatus DBImpl::CreateWAL(uint64_t log_file_num, uint64_t recycle_log_number,
     *new_log = new log::Writer(std::move(file_writer), log_file_num,
                                immutable_db_options_.recycle_log_file_num > 0,
                                immutable_db_options_.manual_wal_flush,
-                               immutable_db_options_.wal_compression);
+                               immutable_db_options_.wal_compression,
+                               wal_compression_thread_pool_.get());
     io_s = (*new_log)->AddCompressionTypeRecord();
   }
   return io_s;
@@ -12,12 +12,21 @@
 #include "db/error_handler.h"
 #include "db/event_helpers.h"
 #include "logging/logging.h"
+#include "monitoring/cf_operation_stats.h"
 #include "monitoring/perf_context_imp.h"
+#include "monitoring/slow_operation_tracker.h"
 #include "options/options_helper.h"
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
 
 namespace ROCKSDB_NAMESPACE {
+namespace {
+CFOperationStats* GetCFOperationStats(ColumnFamilyHandle* column_family) {
+  auto cfh = static_cast_with_check<ColumnFamilyHandleImpl>(column_family);
+  return cfh->cfd()->internal_stats()->GetCFOperationStats();
+}
+}  // namespace
+
 // Convenience methods
 Status DBImpl::Put(const WriteOptions& o, ColumnFamilyHandle* column_family,
                    const Slice& key, const Slice& val) {
@@ -25,6 +34,9 @@ Status DBImpl::Put(const WriteOptions& o, ColumnFamilyHandle* column_family,
   if (!s.ok()) {
     return s;
   }
+  CFOperationTimer cf_op_timer(immutable_db_options_.clock,
+                               GetCFOperationStats(column_family),
+                               CFOperationStats::kWrite);
   return DB::Put(o, column_family, key, val);
 }
 
@@ -34,6 +46,9 @@ Status DBImpl::Put(const WriteOptions& o, ColumnFamilyHandle* column_family,
   if (!s.ok()) {
     return s;
   }
+  CFOperationTimer cf_op_timer(immutable_db_options_.clock,
+                               GetCFOperationStats(column_family),
+                               CFOperationStats::kWrite);
   return DB::Put(o, column_family, key, ts, val);
 }
 
@@ -45,6 +60,9 @@ Status DBImpl::PutEntity(const WriteOptions& options,
     return s;
   }
 
+  CFOperationTimer cf_op_timer(immutable_db_options_.clock,
+                               GetCFOperationStats(column_family),
+                               CFOperationStats::kWrite);
   return DB::PutEntity(options, column_family, key, columns);
 }
 
@@ -58,6 +76,9 @@ Status DBImpl::Merge(const WriteOptions& o, ColumnFamilyHandle* column_family,
   if (!cfh->cfd()->ioptions()->merge_operator) {
     return Status::NotSupported("Provide a merge_operator when opening DB");
   } else {
+    CFOperationTimer cf_op_timer(immutable_db_options_.clock,
+                                 GetCFOperationStats(column_family),
+                                 CFOperationStats::kWrite);
     return DB::Merge(o, column_family, key, val);
   }
 }
@@ -68,6 +89,9 @@ Status DBImpl::Merge(const WriteOptions& o, ColumnFamilyHandle* column_family,
   if (!s.ok()) {
     return s;
   }
+  CFOperationTimer cf_op_timer(immutable_db_options_.clock,
+                               GetCFOperationStats(column_family),
+                               CFOperationStats::kWrite);
   return DB::Merge(o, column_family, key, ts, val);
 }
 
@@ -77,6 +101,9 @@ Status DBImpl::Delete(const WriteOptions& write_options,
   if (!s.ok()) {
     return s;
   }
+  CFOperationTimer cf_op_timer(immutable_db_options_.clock,
+                               GetCFOperationStats(column_family),
+                               CFOperationStats::kWrite);
   return DB::Delete(write_options, column_family, key);
 }
 
@@ -87,6 +114,9 @@ Status DBImpl::Delete(const WriteOptions& write_options,
   if (!s.ok()) {
     return s;
   }
+  CFOperationTimer cf_op_timer(immutable_db_options_.clock,
+                               GetCFOperationStats(column_family),
+                               CFOperationStats::kWrite);
   return DB::Delete(write_options, column_family, key, ts);
 }
 
@@ -97,6 +127,9 @@ Status DBImpl::SingleDelete(const WriteOptions& write_options,
   if (!s.ok()) {
     return s;
   }
+  CFOperationTimer cf_op_timer(immutable_db_options_.clock,
+                               GetCFOperationStats(column_family),
+                               CFOperationStats::kWrite);
   return DB::SingleDelete(write_options, column_family, key);
 }
 
@@ -107,6 +140,9 @@ Status DBImpl::SingleDelete(const WriteOptions& write_options,
   if (!s.ok()) {
     return s;
   }
+  CFOperationTimer cf_op_timer(immutable_db_options_.clock,
+                               GetCFOperationStats(column_family),
+                               CFOperationStats::kWrite);
   return DB::SingleDelete(write_options, column_family, key, ts);
 }
 
@@ -117,6 +153,9 @@ Status DBImpl::DeleteRange(const WriteOptions& write_options,
   if (!s.ok()) {
     return s;
   }
+  CFOperationTimer cf_op_timer(immutable_db_options_.clock,
+                               GetCFOperationStats(column_family),
+                               CFOperationStats::kWrite);
   return DB::DeleteRange(write_options, column_family, begin_key, end_key);
 }
 
@@ -128,6 +167,9 @@ Status DBImpl::DeleteRange(const WriteOptions& write_options,
   if (!s.ok()) {
     return s;
   }
+  CFOperationTimer cf_op_timer(immutable_db_options_.clock,
+                               GetCFOperationStats(column_family),
+                               CFOperationStats::kWrite);
   return DB::DeleteRange(write_options, column_family, begin_key, end_key, ts);
 }
 
@@ -173,6 +215,8 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
                          size_t batch_cnt,
                          PreReleaseCallback* pre_release_callback,
                          PostMemTableCallback* post_memtable_callback) {
+  SlowOperationTracker slow_op_tracker(&immutable_db_options_,
+                                       SlowOperationType::kWrite, nullptr);
   assert(!seq_per_batch_ || batch_cnt != 0);
   assert(my_batch == nullptr || my_batch->Count() == 0 ||
          write_options.protection_bytes_per_key == 0 ||
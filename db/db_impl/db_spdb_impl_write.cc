@@ -433,7 +433,17 @@ void DBImpl::ResumeSpdbWrites() {
 IOStatus DBImpl::SpdbSyncWAL(uint64_t offset, uint64_t size) {
   IOStatus io_s;
   StopWatch sw(immutable_db_options_.clock, stats_, WAL_FILE_SYNC_MICROS);
-  {
+  if (!immutable_db_options_.manual_wal_flush) {
+    // The WAL cannot be switched while spdb writes are in flight, so the
+    // writer can be used without log_write_mutex_. Releasing it lets the next
+    // batch group append to the WAL while this sync is in progress.
+    log::Writer* log_writer;
+    {
+      InstrumentedMutexLock l(&log_write_mutex_);
+      log_writer = logs_.back().writer;
+    }
+    io_s = log_writer->SyncRange(immutable_db_options_.use_fsync, offset, size);
+  } else {
     InstrumentedMutexLock l(&log_write_mutex_);
     log::Writer* log_writer = logs_.back().writer;
     io_s = log_writer->SyncRange(immutable_db_options_.use_fsync, offset, size);
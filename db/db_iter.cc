@@ -13,6 +13,7 @@
 #include <limits>
 #include <string>
 
+#include "db/blob/blob_index.h"
 #include "db/dbformat.h"
 #include "db/merge_context.h"
 #include "db/merge_helper.h"
@@ -21,6 +22,9 @@
 #include "file/filename.h"
 #include "logging/logging.h"
 #include "memory/arena.h"
+#include "monitoring/cf_operation_stats.h"
+#include "monitoring/perf_context_sampler.h"
+#include "monitoring/slow_operation_tracker.h"
 #include "monitoring/perf_context_imp.h"
 #include "rocksdb/env.h"
 #include "rocksdb/iterator.h"
@@ -74,14 +78,25 @@ DBIter::DBIter(Env* _env, const ReadOptions& read_options,
       read_tier_(read_options.read_tier),
       fill_cache_(read_options.fill_cache),
       verify_checksums_(read_options.verify_checksums),
+      blob_readahead_size_(read_options.blob_readahead_size),
       expose_blob_index_(expose_blob_index),
       is_blob_(false),
       arena_mode_(arena_mode),
       db_impl_(db_impl),
       cfd_(cfd),
+      cf_operation_stats_(cfd != nullptr
+                              ? cfd->internal_stats()->GetCFOperationStats()
+                              : nullptr),
+      perf_context_sampler_(
+          cfd != nullptr ? cfd->internal_stats()->GetPerfContextSampler()
+                         : nullptr),
       timestamp_ub_(read_options.timestamp),
       timestamp_lb_(read_options.iter_start_ts),
-      timestamp_size_(timestamp_ub_ ? timestamp_ub_->size() : 0) {
+      timestamp_size_(timestamp_ub_ ? timestamp_ub_->size() : 0),
+      skip_by_byte_equality_(
+          timestamp_size_ == 0 && timestamp_lb_ == nullptr &&
+          expect_total_order_inner_iter_ &&
+          !cmp->CanKeysWithDifferentByteContentsBeEqual()) {
   RecordTick(statistics_, NO_ITERATOR_CREATED);
   if (pin_thru_lifetime_) {
     pinned_iters_mgr_.StartPinning();
@@ -132,6 +147,8 @@ void DBIter::Next() {
   assert(status_.ok());
 
   PERF_CPU_TIMER_GUARD(iter_next_cpu_nanos, clock_);
+  CFOperationTimer cf_op_timer(clock_, cf_operation_stats_,
+                               CFOperationStats::kNext);
   // Release temporarily pinned blocks from last operation
   ReleaseTempPinnedData();
   ResetBlobValue();
@@ -200,11 +217,29 @@ bool DBIter::SetBlobValueIfNeeded(const Slice& user_key,
   read_options.fill_cache = fill_cache_;
   read_options.verify_checksums = verify_checksums_;
 
-  constexpr FilePrefetchBuffer* prefetch_buffer = nullptr;
-  constexpr uint64_t* bytes_read = nullptr;
+  BlobIndex decoded_blob_index;
+  Status s = decoded_blob_index.DecodeFrom(blob_index);
+
+  if (s.ok()) {
+    // Blobs are written to blob files in key order, so the values of
+    // consecutive keys of a forward scan are usually adjacent in the same blob
+    // file and can be served from a single larger read.
+    FilePrefetchBuffer* prefetch_buffer = nullptr;
+    if (blob_readahead_size_ > 0 && direction_ == kForward &&
+        !decoded_blob_index.IsInlined()) {
+      if (!blob_prefetch_buffers_) {
+        blob_prefetch_buffers_.reset(
+            new PrefetchBufferCollection(blob_readahead_size_));
+      }
+      prefetch_buffer = blob_prefetch_buffers_->GetOrCreatePrefetchBuffer(
+          decoded_blob_index.file_number());
+    }
 
-  const Status s = version_->GetBlob(read_options, user_key, blob_index,
-                                     prefetch_buffer, &blob_value_, bytes_read);
+    constexpr uint64_t* bytes_read = nullptr;
+
+    s = version_->GetBlob(read_options, user_key, decoded_blob_index,
+                          prefetch_buffer, &blob_value_, bytes_read);
+  }
 
   if (!s.ok()) {
     status_ = s;
@@ -334,8 +369,7 @@ bool DBIter::FindNextUserEntryInternal(bool skipping_saved_key,
       // have different timestamps and zero sequence number on the bottommost
       // level. This may change in the future.
       if ((!is_prev_key_seqnum_zero || timestamp_size_ > 0) &&
-          skipping_saved_key &&
-          CompareKeyForSkip(ikey_.user_key, saved_key_.GetUserKey()) <= 0) {
+          skipping_saved_key && IsSavedUserKeyForward(ikey_.user_key)) {
         num_skipped++;  // skip this entry
         PERF_COUNTER_ADD(internal_key_skipped_count, 1);
       } else {
@@ -1446,6 +1480,13 @@ void DBIter::SetSavedKeyToSeekForPrevTarget(const Slice& target) {
 void DBIter::Seek(const Slice& target) {
   PERF_CPU_TIMER_GUARD(iter_seek_cpu_nanos, clock_);
   StopWatch sw(clock_, statistics_, DB_SEEK);
+  CFOperationTimer cf_op_timer(clock_, cf_operation_stats_,
+                               CFOperationStats::kSeek);
+  PerfContextSampleGuard perf_sample(clock_, perf_context_sampler_,
+                                     PerfContextSampler::kSeek);
+  SlowOperationTracker slow_op_tracker(
+      cfd_ != nullptr ? cfd_->ioptions() : nullptr, SlowOperationType::kSeek,
+      cfd_ != nullptr ? &cfd_->GetName() : nullptr);
 
   if (db_impl_ != nullptr && cfd_ != nullptr) {
     // TODO: What do we do if this returns an error?
@@ -1519,6 +1560,13 @@ void DBIter::Seek(const Slice& target) {
 void DBIter::SeekForPrev(const Slice& target) {
   PERF_CPU_TIMER_GUARD(iter_seek_cpu_nanos, clock_);
   StopWatch sw(clock_, statistics_, DB_SEEK);
+  CFOperationTimer cf_op_timer(clock_, cf_operation_stats_,
+                               CFOperationStats::kSeek);
+  PerfContextSampleGuard perf_sample(clock_, perf_context_sampler_,
+                                     PerfContextSampler::kSeek);
+  SlowOperationTracker slow_op_tracker(
+      cfd_ != nullptr ? cfd_->ioptions() : nullptr, SlowOperationType::kSeek,
+      cfd_ != nullptr ? &cfd_->GetName() : nullptr);
 
   if (db_impl_ != nullptr && cfd_ != nullptr) {
     // TODO: What do we do if this returns an error?
@@ -9,10 +9,14 @@
 
 #pragma once
 #include <cstdint>
+#include <cstring>
 #include <string>
 
+#include "db/blob/prefetch_buffer_collection.h"
 #include "db/db_impl/db_impl.h"
 #include "db/range_del_aggregator.h"
+#include "monitoring/cf_operation_stats.h"
+#include "monitoring/perf_context_sampler.h"
 #include "memory/arena.h"
 #include "options/cf_options.h"
 #include "rocksdb/db.h"
@@ -293,6 +297,33 @@ class DBIter final : public Iterator {
                : user_comparator_.CompareWithoutTimestamp(a, b);
   }
 
+  // Returns true if `user_key` is the user key held in saved_key_. Only used
+  // during forward iteration, where `user_key` is never ordered before the
+  // saved key, so "less than or equal" reduces to "equal". Keys of a scan
+  // often share a long prefix and differ only near their end, so when
+  // equality is byte equality the tails are compared first and distinct keys
+  // are told apart without re-examining the shared prefix.
+  inline bool IsSavedUserKeyForward(const Slice& user_key) {
+    const Slice saved_user_key = saved_key_.GetUserKey();
+    if (!skip_by_byte_equality_) {
+      return CompareKeyForSkip(user_key, saved_user_key) <= 0;
+    }
+    assert(CompareKeyForSkip(user_key, saved_user_key) >= 0);
+    const size_t n = user_key.size();
+    if (n != saved_user_key.size()) {
+      return false;
+    }
+    constexpr size_t kTailSize = sizeof(uint64_t);
+    if (n <= kTailSize) {
+      return memcmp(user_key.data(), saved_user_key.data(), n) == 0;
+    }
+    // Each byte is compared once: the tail first, then the rest
+    const size_t head_size = n - kTailSize;
+    return memcmp(user_key.data() + head_size,
+                  saved_user_key.data() + head_size, kTailSize) == 0 &&
+           memcmp(user_key.data(), saved_user_key.data(), head_size) == 0;
+  }
+
   // Retrieves the blob value for the specified user key using the given blob
   // index when using the integrated BlobDB implementation.
   bool SetBlobValueIfNeeded(const Slice& user_key, const Slice& blob_index);
@@ -379,6 +410,11 @@ class DBIter final : public Iterator {
   ReadTier read_tier_;
   bool fill_cache_;
   bool verify_checksums_;
+  // Readahead size for blob files, see ReadOptions::blob_readahead_size
+  const size_t blob_readahead_size_;
+  // Per blob file prefetch buffers, created on the first blob fetched when
+  // blob_readahead_size_ is non-zero
+  std::unique_ptr<PrefetchBufferCollection> blob_prefetch_buffers_;
   // Whether the iterator is allowed to expose blob references. Set to true when
   // the stacked BlobDB implementation is used, false otherwise.
   bool expose_blob_index_;
@@ -390,9 +426,17 @@ class DBIter final : public Iterator {
   PinnedIteratorsManager pinned_iters_mgr_;
   DBImpl* db_impl_;
   ColumnFamilyData* cfd_;
+  // nullptr unless the column family keeps operation latency stats
+  CFOperationStats* const cf_operation_stats_;
+  // nullptr unless the column family samples PerfContext breakdowns
+  PerfContextSampler* const perf_context_sampler_;
   const Slice* const timestamp_ub_;
   const Slice* const timestamp_lb_;
   const size_t timestamp_size_;
+  // True if the inner iterator is totally ordered, user keys have no
+  // timestamps and two user keys are equal only when their bytes are, see
+  // IsSavedUserKeyForward()
+  const bool skip_by_byte_equality_;
   std::string saved_timestamp_;
 };
 
@@ -756,6 +756,53 @@ TEST_F(DBIteratorTest, DBIteratorUseSkipCountSkips) {
   ASSERT_EQ(TestGetTickerCount(options, NUMBER_OF_RESEEKS_IN_ITERATION), 3u);
 }
 
+TEST_F(DBIteratorTest, DBIteratorSkipKeysWithLongSharedPrefix) {
+  ReadOptions ro;
+  Options options;
+
+  // Keys of the same length sharing a long prefix, some of them also sharing
+  // their last bytes, so that the hidden versions of a user key are only
+  // distinguished from the next user key by the bytes in between.
+  const std::string prefix(40, 'p');
+  const std::string k1 = prefix + "a00000001";
+  const std::string k1x = k1 + "x";
+  const std::string k2 = prefix + "a00000002";
+  const std::string k3 = prefix + "b00000002";
+
+  TestIterator* internal_iter = new TestIterator(BytewiseComparator());
+  internal_iter->AddPut(k1, "v1");
+  internal_iter->AddPut(k1, "v2");
+  internal_iter->AddPut(k1x, "v3");
+  internal_iter->AddPut(k2, "v4");
+  internal_iter->AddDeletion(k2);
+  internal_iter->AddPut(k3, "v5");
+  internal_iter->Finish();
+
+  std::unique_ptr<Iterator> db_iter(NewDBIterator(
+      env_, ro, ImmutableOptions(options), MutableCFOptions(options),
+      BytewiseComparator(), internal_iter, nullptr /* version */,
+      kMaxSequenceNumber /* sequence */,
+      options.max_sequential_skip_in_iterations, nullptr /* read_callback */));
+  db_iter->SeekToFirst();
+  ASSERT_TRUE(db_iter->Valid());
+  ASSERT_EQ(db_iter->key().ToString(), k1);
+  ASSERT_EQ(db_iter->value().ToString(), "v2");
+
+  db_iter->Next();
+  ASSERT_TRUE(db_iter->Valid());
+  ASSERT_EQ(db_iter->key().ToString(), k1x);
+  ASSERT_EQ(db_iter->value().ToString(), "v3");
+
+  db_iter->Next();
+  ASSERT_TRUE(db_iter->Valid());
+  ASSERT_EQ(db_iter->key().ToString(), k3);
+  ASSERT_EQ(db_iter->value().ToString(), "v5");
+
+  db_iter->Next();
+  ASSERT_FALSE(db_iter->Valid());
+  ASSERT_OK(db_iter->status());
+}
+
 TEST_F(DBIteratorTest, DBIteratorUseSkip) {
   ReadOptions ro;
   Options options;
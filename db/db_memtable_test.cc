@@ -335,6 +335,71 @@ TEST_F(DBMemTableTest, ColumnFamilyId) {
   }
 }
 
+TEST_F(DBMemTableTest, ShardedSkipList) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.allow_concurrent_memtable_write = true;
+  options.memtable_factory.reset(NewShardedSkipListRepFactory(4));
+  DestroyAndReopen(options);
+
+  // Write overlapping keys from several threads so every shard gets multiple
+  // versions of some keys.
+  const int kNumThreads = 4;
+  const int kNumKeys = 1000;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = t; i < kNumKeys; i += 2) {
+        ASSERT_OK(Put(Key(i), "v" + std::to_string(t)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_OK(Delete(Key(kNumKeys / 2)));
+
+  auto verify = [&]() {
+    for (int i = 0; i < kNumKeys; ++i) {
+      if (i == kNumKeys / 2) {
+        ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+      } else {
+        ASSERT_NE("NOT_FOUND", Get(Key(i)));
+      }
+    }
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int count = 0;
+    std::string prev_key;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_LT(prev_key, iter->key().ToString());
+      prev_key = iter->key().ToString();
+      ++count;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys - 1, count);
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      --count;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(0, count);
+
+    // Switch directions in the middle of the memtable.
+    iter->Seek(Key(10));
+    ASSERT_TRUE(iter->Valid());
+    iter->Next();
+    ASSERT_EQ(Key(11), iter->key());
+    iter->Prev();
+    ASSERT_EQ(Key(10), iter->key());
+    iter->Prev();
+    ASSERT_EQ(Key(9), iter->key());
+    iter->Next();
+    ASSERT_EQ(Key(10), iter->key());
+  };
+  verify();
+  ASSERT_OK(Flush());
+  verify();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
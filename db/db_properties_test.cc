@@ -2107,6 +2107,137 @@ TEST_F(DBPropertiesTest, GetMapPropertyBlockCacheEntryStats) {
   ASSERT_EQ(3 * kNumCacheEntryRoles + 4, values.size());
 }
 
+TEST_F(DBPropertiesTest, CFLatencyStats) {
+  Options options = CurrentOptions();
+  options.num_levels = 4;
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.no_block_cache = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  // Not available unless enabled
+  CreateAndReopenWithCF({"pikachu"}, options);
+  std::map<std::string, std::string> values;
+  ASSERT_FALSE(dbfull()->GetMapProperty(handles_[1],
+                                        DB::Properties::kCFLatencyStats,
+                                        &values));
+  std::string prop;
+  ASSERT_TRUE(dbfull()->GetProperty(handles_[1], DB::Properties::kCFStats,
+                                    &prop));
+  ASSERT_EQ(std::string::npos, prop.find("Operation Latency Histograms"));
+
+  options.enable_cf_latency_stats = true;
+  ReopenWithColumnFamilies({"default", "pikachu"}, options);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Put(1, Key(i), "value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush(1));
+  ASSERT_OK(Delete(1, Key(0)));
+
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_EQ("value" + std::to_string(i + 1), Get(1, Key(i + 1)));
+  }
+  std::vector<ColumnFamilyHandle*> cfs(2, handles_[1]);
+  std::string key1 = Key(1);
+  std::string key2 = Key(2);
+  std::vector<Slice> keys{key1, key2};
+  std::vector<std::string> mget_values;
+  for (const auto& s : db_->MultiGet(ReadOptions(), cfs, keys, &mget_values)) {
+    ASSERT_OK(s);
+  }
+  {
+    std::unique_ptr<Iterator> iter(
+        db_->NewIterator(ReadOptions(), handles_[1]));
+    iter->Seek(Key(1));
+    int count = 0;
+    for (; iter->Valid(); iter->Next()) {
+      ++count;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(9, count);
+  }
+
+  ASSERT_TRUE(dbfull()->GetMapProperty(
+      handles_[1], DB::Properties::kCFLatencyStats, &values));
+  ASSERT_EQ("5", values["get.count"]);
+  ASSERT_EQ("1", values["multiget.count"]);
+  ASSERT_EQ("1", values["seek.count"]);
+  ASSERT_EQ("9", values["next.count"]);
+  ASSERT_EQ("11", values["write.count"]);
+  ASSERT_NE("0", values["level0.bytes-read"]);
+  ASSERT_EQ("0", values["level1.bytes-read"]);
+  ASSERT_EQ(static_cast<size_t>(5 * 6 + options.num_levels), values.size());
+
+  // The operations on the default column family are counted separately
+  ASSERT_TRUE(dbfull()->GetMapProperty(DB::Properties::kCFLatencyStats,
+                                       &values));
+  ASSERT_EQ("0", values["get.count"]);
+  ASSERT_EQ("0", values["write.count"]);
+
+  ASSERT_TRUE(dbfull()->GetProperty(handles_[1], DB::Properties::kCFStats,
+                                    &prop));
+  ASSERT_NE(std::string::npos,
+            prop.find("** Operation Latency Histograms [pikachu] **"));
+  ASSERT_NE(std::string::npos, prop.find("** get latency histogram"));
+  ASSERT_NE(std::string::npos,
+            prop.find("** Point lookup bytes read by level"));
+}
+
+TEST_F(DBPropertiesTest, PerfContextSamples) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.no_block_cache = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  std::string prop;
+  ASSERT_FALSE(
+      dbfull()->GetProperty(DB::Properties::kPerfContextSamples, &prop));
+
+  options.perf_context_sample_rate = 2;
+  Reopen(options);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+
+  SetPerfLevel(PerfLevel::kDisable);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ("value" + std::to_string(i), Get(Key(i)));
+  }
+  // The perf level of the thread is restored after a sampled operation
+  ASSERT_EQ(PerfLevel::kDisable, GetPerfLevel());
+  ASSERT_FALSE(get_perf_context()->per_level_perf_context_enabled);
+  SetPerfLevel(PerfLevel::kEnableCount);
+
+  std::map<std::string, std::string> values;
+  ASSERT_TRUE(
+      dbfull()->GetMapProperty(DB::Properties::kPerfContextSamples, &values));
+  ASSERT_EQ("5", values["get.total_nanos.count"]);
+  ASSERT_EQ("5", values["get.block_read_nanos.count"]);
+  ASSERT_EQ("5", values["get.level0.get_from_table_nanos.count"]);
+  ASSERT_EQ("0", values["get.level1.get_from_table_nanos.count"]);
+  ASSERT_EQ("0", values["seek.total_nanos.count"]);
+
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    for (int i = 0; i < 4; ++i) {
+      iter->Seek(Key(i));
+      ASSERT_TRUE(iter->Valid());
+    }
+  }
+  ASSERT_TRUE(
+      dbfull()->GetMapProperty(DB::Properties::kPerfContextSamples, &values));
+  ASSERT_EQ("2", values["seek.total_nanos.count"]);
+
+  ASSERT_TRUE(
+      dbfull()->GetProperty(DB::Properties::kPerfContextSamples, &prop));
+  ASSERT_NE(std::string::npos,
+            prop.find("** Sampled PerfContext Breakdown [default] (1 in 2 "
+                      "operations) **"));
+  ASSERT_NE(std::string::npos, prop.find("get.level0.get_from_table_nanos"));
+}
+
 TEST_F(DBPropertiesTest, WriteStallStatsSanityCheck) {
   for (uint32_t i = 0; i < static_cast<uint32_t>(WriteStallCause::kNone); ++i) {
     WriteStallCause cause = static_cast<WriteStallCause>(i);
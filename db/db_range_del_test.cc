@@ -387,6 +387,66 @@ TEST_F(DBRangeDelTest, CompactionRemovesCoveredKeys) {
   }
 }
 
+TEST_F(DBRangeDelTest, CompactionSkipsCoveredInputFiles) {
+  const int kNumPerFile = 10;
+  Options opts = CurrentOptions();
+  opts.disable_auto_compactions = true;
+  opts.num_levels = 3;
+
+  for (bool hold_snapshot : {false, true}) {
+    DestroyAndReopen(opts);
+
+    // Two L2 files, the second of which ends up covered by a range tombstone
+    // in L1.
+    for (int i = 0; i < 2; ++i) {
+      for (int j = 0; j < kNumPerFile; ++j) {
+        ASSERT_OK(Put(Key(i * kNumPerFile + j), "val"));
+      }
+      ASSERT_OK(Flush());
+      MoveFilesToLevel(2);
+    }
+    ASSERT_EQ(2, NumTableFilesAtLevel(2));
+
+    const Snapshot* snapshot = hold_snapshot ? db_->GetSnapshot() : nullptr;
+    ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                               Key(kNumPerFile - 1), Key(3 * kNumPerFile)));
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+
+    int num_skipped_files = 0;
+    SyncPoint::GetInstance()->SetCallBack(
+        "VersionSet::MakeInputIterator:SkipCoveredFile",
+        [&](void* /* arg */) { ++num_skipped_files; });
+    SyncPoint::GetInstance()->EnableProcessing();
+
+    ASSERT_OK(dbfull()->TEST_CompactRange(1, nullptr, nullptr, nullptr,
+                                          true /* disallow_trivial_move */));
+
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+
+    // With a snapshot between the keys and the tombstone the keys are still
+    // needed, so the file has to be read.
+    ASSERT_EQ(hold_snapshot ? 0 : 1, num_skipped_files);
+    ASSERT_EQ(0, NumTableFilesAtLevel(1));
+
+    for (int i = 0; i < 2 * kNumPerFile; ++i) {
+      if (i < kNumPerFile - 1) {
+        ASSERT_EQ("val", Get(Key(i)));
+      } else {
+        ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+      }
+      if (snapshot != nullptr) {
+        ASSERT_EQ("val", Get(Key(i), snapshot));
+      }
+    }
+
+    if (snapshot != nullptr) {
+      db_->ReleaseSnapshot(snapshot);
+    }
+  }
+}
+
 TEST_F(DBRangeDelTest, ValidLevelSubcompactionBoundaries) {
   const int kNumPerFile = 100, kNumFiles = 4, kFileBytes = 100 << 10;
   Options options = CurrentOptions();
@@ -1429,6 +1429,63 @@ TEST_F(DBTest2, PresetCompressionDictLocality) {
   }
 }
 
+TEST_F(DBTest2, PresetCompressionDictReuseAcrossFiles) {
+  if (!ZSTD_Supported()) {
+    return;
+  }
+  // Same setup as PresetCompressionDictLocality, but the output files of the
+  // compaction reuse the dictionary of the first one.
+  const int kNumEntriesPerFile = 1 << 10;  // 1KB
+  const int kNumBytesPerEntry = 1 << 10;   // 1KB
+  const int kNumFiles = 4;
+  Options options = CurrentOptions();
+  options.compression = kZSTD;
+  options.compression_opts.max_dict_bytes = 1 << 14;        // 16KB
+  options.compression_opts.zstd_max_train_bytes = 1 << 18;  // 256KB
+  options.compression_opts.reuse_dict_across_files = true;
+  options.target_file_size_base = kNumEntriesPerFile * kNumBytesPerEntry;
+  Reopen(options);
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumFiles; ++i) {
+    for (int j = 0; j < kNumEntriesPerFile; ++j) {
+      values.emplace_back(rnd.RandomString(kNumBytesPerEntry));
+      ASSERT_OK(Put(Key(i * kNumEntriesPerFile + j), values.back()));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+    ASSERT_EQ(NumTableFilesAtLevel(1), i + 1);
+  }
+
+  std::vector<std::string> compression_dicts;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTableBuilder::WriteCompressionDictBlock:RawDict",
+      [&](void* arg) {
+        compression_dicts.emplace_back(static_cast<Slice*>(arg)->ToString());
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+  CompactRangeOptions compact_range_opts;
+  compact_range_opts.bottommost_level_compaction =
+      BottommostLevelCompaction::kForceOptimized;
+  ASSERT_OK(db_->CompactRange(compact_range_opts, nullptr, nullptr));
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // Every output file stores the same dictionary.
+  ASSERT_GT(NumTableFilesAtLevel(1), 1);
+  ASSERT_EQ(NumTableFilesAtLevel(1),
+            static_cast<int>(compression_dicts.size()));
+  ASSERT_FALSE(compression_dicts[0].empty());
+  for (size_t i = 1; i < compression_dicts.size(); ++i) {
+    ASSERT_EQ(compression_dicts[0], compression_dicts[i]);
+  }
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], Get(Key(static_cast<int>(i))));
+  }
+}
+
 class PresetCompressionDictTest
     : public DBTestBase,
       public testing::WithParamInterface<std::tuple<CompressionType, bool>> {
@@ -4943,6 +5000,105 @@ TEST_F(DBTest2, TraceWithLimit) {
   ASSERT_OK(DestroyDB(dbname2, options));
 }
 
+TEST_F(DBTest2, TraceReplayKeyOrderAndRemapping) {
+  Options options = CurrentOptions();
+  WriteOptions wo;
+  ReadOptions ro;
+  TraceOptions trace_opts;
+  EnvOptions env_opts;
+  DestroyAndReopen(options);
+
+  constexpr int kNumKeys = 8;
+  constexpr int kNumWrites = 400;
+  std::string trace_filename = dbname_ + "/rocksdb.trace_order";
+  std::unique_ptr<TraceWriter> trace_writer;
+  ASSERT_OK(NewFileTraceWriter(env_, env_opts, trace_filename, &trace_writer));
+  ASSERT_OK(db_->StartTrace(trace_opts, std::move(trace_writer)));
+  for (int i = 0; i < kNumWrites; ++i) {
+    const std::string key = "k" + std::to_string(i % kNumKeys);
+    if (i % 7 == 0) {
+      ASSERT_OK(db_->Delete(wo, key));
+    } else {
+      ASSERT_OK(db_->Put(wo, key, std::to_string(i)));
+    }
+  }
+  WriteBatch batch;
+  // Ordered with the other writes to its first key
+  ASSERT_OK(batch.Put("k0", "from_batch"));
+  ASSERT_OK(batch.Put("batch_key", "batch_value"));
+  ASSERT_OK(db_->Write(wo, &batch));
+  std::string value;
+  ASSERT_OK(db_->Get(ro, "k1", &value));
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+  iter->Seek("k2");
+  ASSERT_TRUE(iter->Valid());
+  iter.reset();
+  ASSERT_OK(db_->EndTrace());
+
+  std::string dbname2 = test::PerThreadDBPath(env_, "/db_replay_order");
+  ASSERT_OK(DestroyDB(dbname2, options));
+  options.create_if_missing = true;
+  DB* db2 = nullptr;
+  ASSERT_OK(DB::Open(options, dbname2, &db2));
+
+  std::unique_ptr<TraceReader> trace_reader;
+  ASSERT_OK(NewFileTraceReader(env_, env_opts, trace_filename, &trace_reader));
+  std::unique_ptr<Replayer> replayer;
+  ASSERT_OK(db2->NewDefaultReplayer({db2->DefaultColumnFamily()},
+                                    std::move(trace_reader), &replayer));
+  ASSERT_OK(replayer->Prepare());
+
+  ReplayOptions replay_opts(4, 1000.0, /*preserve_key_order=*/true);
+  replay_opts.key_remapper = [](const Slice& key) {
+    return "r_" + key.ToString();
+  };
+  std::atomic<int> num_writes{0};
+  std::atomic<int> num_gets{0};
+  std::atomic<int> num_seeks{0};
+  auto res_cb = [&](Status exec_s, std::unique_ptr<TraceRecordResult>&& res) {
+    ASSERT_OK(exec_s);
+    ASSERT_TRUE(res != nullptr);
+    switch (res->GetTraceType()) {
+      case kTraceWrite:
+        num_writes++;
+        break;
+      case kTraceGet:
+        num_gets++;
+        break;
+      case kTraceIteratorSeek:
+        num_seeks++;
+        break;
+      default:
+        FAIL();
+    }
+  };
+  ASSERT_OK(replayer->Replay(replay_opts, res_cb));
+  replayer.reset();
+  ASSERT_EQ(kNumWrites + 1, num_writes.load());
+  ASSERT_EQ(1, num_gets.load());
+  ASSERT_EQ(1, num_seeks.load());
+
+  // The writes to each key were replayed in order, on the remapped keys
+  ASSERT_OK(db2->Get(ro, "r_k0", &value));
+  ASSERT_EQ("from_batch", value);
+  ASSERT_OK(db2->Get(ro, "r_batch_key", &value));
+  ASSERT_EQ("batch_value", value);
+  for (int k = 1; k < kNumKeys; ++k) {
+    int last = kNumWrites - kNumKeys + k;
+    Status s = db2->Get(ro, "r_k" + std::to_string(k), &value);
+    if (last % 7 == 0) {
+      ASSERT_TRUE(s.IsNotFound());
+    } else {
+      ASSERT_OK(s);
+      ASSERT_EQ(std::to_string(last), value);
+    }
+  }
+  ASSERT_TRUE(db2->Get(ro, "k1", &value).IsNotFound());
+
+  delete db2;
+  ASSERT_OK(DestroyDB(dbname2, options));
+}
+
 TEST_F(DBTest2, TraceWithSampling) {
   Options options = CurrentOptions();
   ReadOptions ro;
@@ -301,6 +301,65 @@ TEST_F(DBWALTest, Recover) {
   } while (ChangeWalOptions());
 }
 
+TEST_F(DBWALTest, PipelinedRecovery) {
+  Options options = CurrentOptions();
+  options.enable_pipelined_wal_recovery = true;
+  options.avoid_flush_during_recovery = false;
+  // Memtables fill up during recovery, so some are flushed while the WAL is
+  // still being read
+  options.write_buffer_size = 64 << 10;
+  options.disable_auto_compactions = true;
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  Random rnd(301);
+  std::map<std::string, std::string> expected[2];
+  for (int i = 0; i < 4000; ++i) {
+    const int cf = i % 2;
+    const std::string key = Key(rnd.Uniform(1000));
+    const std::string value = rnd.RandomString(100 + rnd.Uniform(100));
+    ASSERT_OK(Put(cf, key, value));
+    expected[cf][key] = value;
+  }
+  const std::string big_value = rnd.RandomString(3 * log::kBlockSize);
+  ASSERT_OK(Put(1, "big", big_value));
+  expected[1]["big"] = big_value;
+
+  for (bool pipelined : {true, false}) {
+    options.enable_pipelined_wal_recovery = pipelined;
+    ReopenWithColumnFamilies({"default", "pikachu"}, options);
+    for (int cf = 0; cf < 2; ++cf) {
+      for (const auto& kv : expected[cf]) {
+        ASSERT_EQ(kv.second, Get(cf, kv.first));
+      }
+    }
+  }
+}
+
+TEST_F(DBWALTest, PipelinedRecoveryTruncatedTail) {
+  Options options = CurrentOptions();
+  options.enable_pipelined_wal_recovery = true;
+  options.wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+  }
+  uint64_t wal_file_id = dbfull()->TEST_LogfileNumber();
+  std::string fname = LogFileName(dbname_, wal_file_id);
+  Close();
+
+  // Cut the last record in half
+  uint64_t wal_size;
+  ASSERT_OK(env_->GetFileSize(fname, &wal_size));
+  ASSERT_OK(test::TruncateFile(env_, fname, wal_size - 8));
+
+  Reopen(options);
+  for (int i = 0; i < 999; ++i) {
+    ASSERT_EQ("v" + std::to_string(i), Get(Key(i)));
+  }
+  ASSERT_EQ("NOT_FOUND", Get(Key(999)));
+}
+
 TEST_F(DBWALTest, RecoverWithTableHandle) {
   do {
     Options options = CurrentOptions();
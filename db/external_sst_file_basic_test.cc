@@ -286,6 +286,103 @@ class ChecksumVerifyHelper {
   }
 };
 
+TEST_F(ExternalSSTFileBasicTest, ParallelSstFileWriter) {
+  Options options = CurrentOptions();
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 2000;
+  const std::string prefix = sst_files_dir_ + "part-";
+  ParallelSstFileWriter writer(EnvOptions(), options, prefix,
+                               4096 /* target_file_size */,
+                               4 /* num_threads */);
+  for (int k = 0; k < kNumKeys; k++) {
+    if (k % 10 == 9) {
+      ASSERT_OK(writer.Delete(Key(k)));
+    } else {
+      ASSERT_OK(writer.Put(Key(k), Key(k) + "_val"));
+    }
+  }
+  // Keys must keep ascending across file boundaries
+  ASSERT_TRUE(writer.Put(Key(0), "bad_val").IsInvalidArgument());
+
+  std::vector<ExternalSstFileInfo> infos;
+  ASSERT_OK(writer.Finish(&infos));
+  ASSERT_GT(infos.size(), 1);
+  ASSERT_NOK(writer.Put(Key(kNumKeys), "bad_val"));
+
+  uint64_t total_entries = 0;
+  std::vector<std::string> files;
+  for (size_t i = 0; i < infos.size(); i++) {
+    if (i > 0) {
+      ASSERT_LT(infos[i - 1].largest_key, infos[i].smallest_key);
+    }
+    total_entries += infos[i].num_entries;
+    files.push_back(infos[i].file_path);
+  }
+  ASSERT_EQ(infos.front().smallest_key, Key(0));
+  ASSERT_EQ(infos.back().largest_key, Key(kNumKeys - 1));
+  ASSERT_EQ(total_entries, kNumKeys);
+
+  ASSERT_OK(Put(Key(9), "before_ingest"));
+  ASSERT_OK(db_->IngestExternalFile(files, IngestExternalFileOptions()));
+  for (int k = 0; k < kNumKeys; k++) {
+    if (k % 10 == 9) {
+      ASSERT_EQ(Get(Key(k)), "NOT_FOUND");
+    } else {
+      ASSERT_EQ(Get(Key(k)), Key(k) + "_val");
+    }
+  }
+
+  ParallelSstFileWriter empty_writer(EnvOptions(), options, prefix, 4096, 2);
+  ASSERT_TRUE(empty_writer.Finish().IsInvalidArgument());
+
+  DestroyAndRecreateExternalSSTFilesDir();
+}
+
+TEST_F(ExternalSSTFileBasicTest, IngestWithParallelPrepare) {
+  Options options = CurrentOptions();
+  options.file_checksum_gen_factory = GetFileChecksumGenCrc32cFactory();
+  DestroyAndReopen(options);
+
+  const int kNumFiles = 16;
+  const int kKeysPerFile = 50;
+  std::vector<std::string> files;
+  for (int f = 0; f < kNumFiles; f++) {
+    SstFileWriter sst_file_writer(EnvOptions(), options);
+    std::string file = sst_files_dir_ + "file" + std::to_string(f) + ".sst";
+    ASSERT_OK(sst_file_writer.Open(file));
+    for (int k = f * kKeysPerFile; k < (f + 1) * kKeysPerFile; k++) {
+      ASSERT_OK(sst_file_writer.Put(Key(k), Key(k) + "_val"));
+    }
+    ASSERT_OK(sst_file_writer.Finish());
+    files.push_back(file);
+  }
+
+  IngestExternalFileOptions ifo;
+  ifo.num_prepare_threads = 4;
+  ifo.verify_checksums_before_ingest = true;
+
+  // A missing file fails the whole batch
+  std::vector<std::string> bad_files = files;
+  bad_files.push_back(sst_files_dir_ + "missing.sst");
+  ASSERT_NOK(db_->IngestExternalFile(bad_files, ifo));
+
+  ASSERT_OK(db_->IngestExternalFile(files, ifo));
+  for (int k = 0; k < kNumFiles * kKeysPerFile; k++) {
+    ASSERT_EQ(Get(Key(k)), Key(k) + "_val");
+  }
+
+  std::vector<LiveFileMetaData> live_files;
+  db_->GetLiveFilesMetaData(&live_files);
+  ASSERT_EQ(live_files.size(), kNumFiles);
+  for (const auto& meta : live_files) {
+    ASSERT_EQ(meta.file_checksum_func_name, "FileChecksumCrc32c");
+    ASSERT_FALSE(meta.file_checksum.empty());
+  }
+
+  DestroyAndRecreateExternalSSTFilesDir();
+}
+
 TEST_F(ExternalSSTFileBasicTest, BasicWithFileChecksumCrc32c) {
   Options options = CurrentOptions();
   options.file_checksum_gen_factory = GetFileChecksumGenCrc32cFactory();
@@ -7,7 +7,9 @@
 #include "db/external_sst_file_ingestion_job.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
+#include <functional>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -17,6 +19,7 @@
 #include "file/file_util.h"
 #include "file/random_access_file_reader.h"
 #include "logging/logging.h"
+#include "port/port.h"
 #include "table/merging_iterator.h"
 #include "table/scoped_arena_iterator.h"
 #include "table/sst_file_writer_collectors.h"
@@ -27,6 +30,38 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+// Calls `fn` for every index in [0, num_items), spreading the calls over up
+// to `num_threads` threads including the calling one.
+void RunInParallel(size_t num_items, int num_threads,
+                   const std::function<void(size_t)>& fn) {
+  size_t num_workers = std::min(
+      num_items, static_cast<size_t>(std::max(num_threads, 1)));
+  if (num_workers <= 1) {
+    for (size_t i = 0; i < num_items; i++) {
+      fn(i);
+    }
+    return;
+  }
+  std::atomic<size_t> next_item{0};
+  auto work = [&]() {
+    for (size_t i = next_item.fetch_add(1); i < num_items;
+         i = next_item.fetch_add(1)) {
+      fn(i);
+    }
+  };
+  std::vector<port::Thread> threads;
+  threads.reserve(num_workers - 1);
+  for (size_t t = 1; t < num_workers; t++) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+}  // namespace
+
 Status ExternalSstFileIngestionJob::Prepare(
     const std::vector<std::string>& external_files_paths,
     const std::vector<std::string>& files_checksums,
@@ -36,10 +71,18 @@ Status ExternalSstFileIngestionJob::Prepare(
   Status status;
 
   // Read the information of files we are ingesting
-  for (const std::string& file_path : external_files_paths) {
-    IngestedFileInfo file_to_ingest;
-    status =
-        GetIngestedFileInfo(file_path, next_file_number++, &file_to_ingest, sv);
+  const size_t num_input_files = external_files_paths.size();
+  std::vector<IngestedFileInfo> infos(num_input_files);
+  std::vector<Status> info_statuses(num_input_files);
+  RunInParallel(num_input_files, ingestion_options_.num_prepare_threads,
+                [&](size_t i) {
+                  info_statuses[i] = GetIngestedFileInfo(
+                      external_files_paths[i], next_file_number + i, &infos[i],
+                      sv);
+                });
+  for (size_t i = 0; i < num_input_files; i++) {
+    IngestedFileInfo& file_to_ingest = infos[i];
+    status = info_statuses[i];
     if (!status.ok()) {
       return status;
     }
@@ -211,21 +254,31 @@ Status ExternalSstFileIngestionJob::Prepare(
     std::vector<std::string> generated_checksum_func_names;
     // Step 1: generate the checksum for ingested sst file.
     if (need_generate_file_checksum_) {
-      for (size_t i = 0; i < files_to_ingest_.size(); i++) {
-        std::string generated_checksum;
-        std::string generated_checksum_func_name;
-        std::string requested_checksum_func_name;
-        // TODO: rate limit file reads for checksum calculation during file
-        // ingestion.
-        IOStatus io_s = GenerateOneFileChecksum(
-            fs_.get(), files_to_ingest_[i].internal_file_path,
-            db_options_.file_checksum_gen_factory.get(),
-            requested_checksum_func_name, &generated_checksum,
-            &generated_checksum_func_name,
-            ingestion_options_.verify_checksums_readahead_size,
-            db_options_.allow_mmap_reads, io_tracer_,
-            db_options_.rate_limiter.get(),
-            Env::IO_TOTAL /* rate_limiter_priority */);
+      const size_t num_ingested_files = files_to_ingest_.size();
+      std::vector<std::string> checksums(num_ingested_files);
+      std::vector<std::string> checksum_func_names(num_ingested_files);
+      std::vector<IOStatus> checksum_statuses(num_ingested_files);
+      RunInParallel(
+          num_ingested_files, ingestion_options_.num_prepare_threads,
+          [&](size_t i) {
+            std::string requested_checksum_func_name;
+            // TODO: rate limit file reads for checksum calculation during
+            // file ingestion.
+            checksum_statuses[i] = GenerateOneFileChecksum(
+                fs_.get(), files_to_ingest_[i].internal_file_path,
+                db_options_.file_checksum_gen_factory.get(),
+                requested_checksum_func_name, &checksums[i],
+                &checksum_func_names[i],
+                ingestion_options_.verify_checksums_readahead_size,
+                db_options_.allow_mmap_reads, io_tracer_,
+                db_options_.rate_limiter.get(),
+                Env::IO_TOTAL /* rate_limiter_priority */);
+          });
+      for (size_t i = 0; i < num_ingested_files; i++) {
+        const std::string& generated_checksum = checksums[i];
+        const std::string& generated_checksum_func_name =
+            checksum_func_names[i];
+        const IOStatus& io_s = checksum_statuses[i];
         if (!io_s.ok()) {
           status = io_s;
           ROCKS_LOG_WARN(db_options_.info_log,
@@ -552,15 +605,23 @@ void ExternalSstFileIngestionJob::UnregisterRange() {
   compaction_input_metdatas_.clear();
 }
 
-void ExternalSstFileIngestionJob::UpdateStats() {
+void ExternalSstFileIngestionJob::UpdateStats(uint64_t write_stop_micros) {
   // Update internal stats for new ingested files
   uint64_t total_keys = 0;
   uint64_t total_l0_files = 0;
   uint64_t total_time = clock_->NowMicros() - job_start_time_;
 
+  ROCKS_LOG_INFO(db_options_.info_log,
+                 "[%s] [AddFile] Ingested %" ROCKSDB_PRIszt
+                 " files in %" PRIu64 " us, writes were stopped for %" PRIu64
+                 " us",
+                 cfd_->GetName().c_str(), files_to_ingest_.size(), total_time,
+                 write_stop_micros);
+
   EventLoggerStream stream = event_logger_->Log();
   stream << "event"
          << "ingest_finished";
+  stream << "write_stop_micros" << write_stop_micros;
   stream << "files_ingested";
   stream.StartArray();
 
@@ -143,9 +143,10 @@ class ExternalSstFileIngestionJob {
   // REQUIRES: Mutex held
   void UnregisterRange();
 
-  // Update column family stats.
+  // Update column family stats. `write_stop_micros` is how long writes to the
+  // DB were stopped while the ingestion was applied.
   // REQUIRES: Mutex held
-  void UpdateStats();
+  void UpdateStats(uint64_t write_stop_micros);
 
   // Cleanup after successful/failed job
   void Cleanup(const Status& status);
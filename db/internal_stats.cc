@@ -248,6 +248,8 @@ static const std::string cfstats = "cfstats";
 static const std::string cfstats_no_file_histogram =
     "cfstats-no-file-histogram";
 static const std::string cf_file_histogram = "cf-file-histogram";
+static const std::string cf_latency_stats = "cf-latency-stats";
+static const std::string perf_context_samples = "perf-context-samples";
 static const std::string cf_write_stall_stats = "cf-write-stall-stats";
 static const std::string dbstats = "dbstats";
 static const std::string db_write_stall_stats = "db-write-stall-stats";
@@ -333,6 +335,10 @@ const std::string DB::Properties::kCFStatsNoFileHistogram =
     rocksdb_prefix + cfstats_no_file_histogram;
 const std::string DB::Properties::kCFFileHistogram =
     rocksdb_prefix + cf_file_histogram;
+const std::string DB::Properties::kCFLatencyStats =
+    rocksdb_prefix + cf_latency_stats;
+const std::string DB::Properties::kPerfContextSamples =
+    rocksdb_prefix + perf_context_samples;
 const std::string DB::Properties::kCFWriteStallStats =
     rocksdb_prefix + cf_write_stall_stats;
 const std::string DB::Properties::kDBWriteStallStats =
@@ -468,6 +474,12 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kCFFileHistogram,
          {false, &InternalStats::HandleCFFileHistogram, nullptr, nullptr,
           nullptr}},
+        {DB::Properties::kCFLatencyStats,
+         {false, &InternalStats::HandleCFLatencyStats, nullptr,
+          &InternalStats::HandleCFLatencyStatsMap, nullptr}},
+        {DB::Properties::kPerfContextSamples,
+         {true, &InternalStats::HandlePerfContextSamples, nullptr,
+          &InternalStats::HandlePerfContextSamplesMap, nullptr}},
         {DB::Properties::kCFWriteStallStats,
          {false, &InternalStats::HandleCFWriteStallStats, nullptr,
           &InternalStats::HandleCFWriteStallStatsMap, nullptr}},
@@ -647,6 +659,13 @@ InternalStats::InternalStats(int num_levels, SystemClock* clock,
       clock_(clock),
       cfd_(cfd),
       started_at_(clock->NowMicros()) {
+  if (cfd_->ioptions()->enable_cf_latency_stats) {
+    cf_operation_stats_.reset(new CFOperationStats(num_levels));
+  }
+  if (cfd_->ioptions()->perf_context_sample_rate > 0) {
+    perf_context_sampler_.reset(
+        new PerfContextSampler(cfd_->ioptions()->perf_context_sample_rate));
+  }
   Cache* block_cache = GetBlockCacheForStats();
   if (block_cache) {
     // Extract or create stats collector. Could fail in rare cases.
@@ -1197,6 +1216,7 @@ bool InternalStats::HandleCFStatsPeriodic(std::string* value,
 
   DumpCFStatsNoFileHistogram(/*is_periodic=*/true, value);
   DumpCFFileHistogram(value);
+  DumpCFLatencyStats(value);
   return true;
 }
 
@@ -1212,6 +1232,42 @@ bool InternalStats::HandleCFFileHistogram(std::string* value,
   return true;
 }
 
+bool InternalStats::HandleCFLatencyStats(std::string* value,
+                                         Slice /*suffix*/) {
+  if (!cf_operation_stats_) {
+    return false;
+  }
+  DumpCFLatencyStats(value);
+  return true;
+}
+
+bool InternalStats::HandleCFLatencyStatsMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/) {
+  if (!cf_operation_stats_) {
+    return false;
+  }
+  cf_operation_stats_->ToMap(values);
+  return true;
+}
+
+bool InternalStats::HandlePerfContextSamples(std::string* value,
+                                             Slice /*suffix*/) {
+  if (!perf_context_sampler_) {
+    return false;
+  }
+  value->append(perf_context_sampler_->ToString(cfd_->GetName()));
+  return true;
+}
+
+bool InternalStats::HandlePerfContextSamplesMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/) {
+  if (!perf_context_sampler_) {
+    return false;
+  }
+  perf_context_sampler_->ToMap(values);
+  return true;
+}
+
 bool InternalStats::HandleCFWriteStallStats(std::string* value,
                                             Slice /*suffix*/) {
   DumpCFStatsWriteStall(value);
@@ -1986,6 +2042,7 @@ void InternalStats::DumpCFStatsWriteStall(std::string* value,
 void InternalStats::DumpCFStats(std::string* value) {
   DumpCFStatsNoFileHistogram(/*is_periodic=*/false, value);
   DumpCFFileHistogram(value);
+  DumpCFLatencyStats(value);
 }
 
 void InternalStats::DumpCFStatsNoFileHistogram(bool is_periodic,
@@ -2197,5 +2254,14 @@ void InternalStats::DumpCFFileHistogram(std::string* value) {
   value->append(oss.str());
 }
 
+void InternalStats::DumpCFLatencyStats(std::string* value) {
+  assert(value);
+  assert(cfd_);
+
+  if (cf_operation_stats_) {
+    value->append(cf_operation_stats_->ToString(cfd_->GetName()));
+  }
+}
+
 
 }  // namespace ROCKSDB_NAMESPACE
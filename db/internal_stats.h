@@ -17,6 +17,8 @@
 
 #include "cache/cache_entry_roles.h"
 #include "db/version_set.h"
+#include "monitoring/cf_operation_stats.h"
+#include "monitoring/perf_context_sampler.h"
 #include "rocksdb/system_clock.h"
 #include "util/hash_containers.h"
 
@@ -528,6 +530,12 @@ class InternalStats {
       h.Clear();
     }
     blob_file_read_latency_.Clear();
+    if (cf_operation_stats_) {
+      cf_operation_stats_->Clear();
+    }
+    if (perf_context_sampler_) {
+      perf_context_sampler_->Clear();
+    }
     cf_stats_snapshot_.Clear();
     db_stats_snapshot_.Clear();
     bg_error_count_ = 0;
@@ -581,6 +589,16 @@ class InternalStats {
 
   HistogramImpl* GetBlobFileReadHist() { return &blob_file_read_latency_; }
 
+  // nullptr unless DBOptions::enable_cf_latency_stats is set
+  CFOperationStats* GetCFOperationStats() const {
+    return cf_operation_stats_.get();
+  }
+
+  // nullptr unless DBOptions::perf_context_sample_rate is set
+  PerfContextSampler* GetPerfContextSampler() const {
+    return perf_context_sampler_.get();
+  }
+
   uint64_t GetBackgroundErrorCount() const { return bg_error_count_; }
 
   uint64_t BumpAndGetBackgroundErrorCount() { return ++bg_error_count_; }
@@ -644,6 +662,7 @@ class InternalStats {
   // if is_periodic = true, it is an internal call by RocksDB periodically to
   // dump the status.
   void DumpCFFileHistogram(std::string* value);
+  void DumpCFLatencyStats(std::string* value);
 
   void DumpCFMapStatsWriteStall(std::map<std::string, std::string>* value);
   void DumpCFStatsWriteStall(std::string* value,
@@ -670,6 +689,8 @@ class InternalStats {
   CompactionStats per_key_placement_comp_stats_;
   std::vector<HistogramImpl> file_read_latency_;
   HistogramImpl blob_file_read_latency_;
+  std::unique_ptr<CFOperationStats> cf_operation_stats_;
+  std::unique_ptr<PerfContextSampler> perf_context_sampler_;
   bool has_cf_change_since_dump_;
   // How many periods of no change since the last time stats are dumped for
   // a periodic dump.
@@ -776,6 +797,12 @@ class InternalStats {
   bool HandleCFStats(std::string* value, Slice suffix);
   bool HandleCFStatsNoFileHistogram(std::string* value, Slice suffix);
   bool HandleCFFileHistogram(std::string* value, Slice suffix);
+  bool HandleCFLatencyStats(std::string* value, Slice suffix);
+  bool HandleCFLatencyStatsMap(std::map<std::string, std::string>* values,
+                               Slice suffix);
+  bool HandlePerfContextSamples(std::string* value, Slice suffix);
+  bool HandlePerfContextSamplesMap(std::map<std::string, std::string>* values,
+                                   Slice suffix);
   bool HandleCFStatsPeriodic(std::string* value, Slice suffix);
   bool HandleCFWriteStallStats(std::string* value, Slice suffix);
   bool HandleCFWriteStallStatsMap(std::map<std::string, std::string>* values,
@@ -1588,6 +1588,85 @@ TEST_F(EventListenerTest, BlobDBFileTest) {
   blob_event_listener->CheckCounters();
 }
 
+class SlowOperationListener : public EventListener {
+ public:
+  void OnSlowOperation(const SlowOperationInfo& info) override {
+    MutexLock l(&mutex_);
+    infos_.push_back(info);
+  }
+
+  std::vector<SlowOperationInfo> GetInfos(SlowOperationType type) {
+    MutexLock l(&mutex_);
+    std::vector<SlowOperationInfo> infos;
+    for (const auto& info : infos_) {
+      if (info.type == type) {
+        infos.push_back(info);
+      }
+    }
+    return infos;
+  }
+
+ private:
+  port::Mutex mutex_;
+  std::vector<SlowOperationInfo> infos_;
+};
+
+TEST_F(EventListenerTest, OnSlowOperation) {
+  constexpr uint64_t kThresholdMicros = 100000;
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.slow_operation_threshold_micros = kThresholdMicros;
+  auto listener = std::make_shared<SlowOperationListener>();
+  options.listeners.push_back(listener);
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("key", "value"));
+  ASSERT_OK(Flush());
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(1, files.size());
+
+  // A fast Get is not reported
+  ASSERT_EQ("value", Get("key"));
+  ASSERT_TRUE(listener->GetInfos(SlowOperationType::kGet).empty());
+
+  SyncPoint::GetInstance()->SetCallBack("DBImpl::GetImpl:1", [&](void*) {
+    env_->SleepForMicroseconds(static_cast<int>(2 * kThresholdMicros));
+  });
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::WriteImpl:BeforeLeaderEnters", [&](void*) {
+        env_->SleepForMicroseconds(static_cast<int>(2 * kThresholdMicros));
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  SetPerfLevel(PerfLevel::kEnableCount);
+  get_perf_context()->Reset();
+  ASSERT_OK(Put("other", "value"));
+  ASSERT_EQ("value", Get("key"));
+  SetPerfLevel(PerfLevel::kDisable);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  auto gets = listener->GetInfos(SlowOperationType::kGet);
+  ASSERT_EQ(1, gets.size());
+  ASSERT_EQ(kDefaultColumnFamilyName, gets[0].cf_name);
+  ASSERT_GE(gets[0].duration_micros, kThresholdMicros);
+  ASSERT_EQ(std::vector<uint64_t>{files[0].file_number}, gets[0].sst_files);
+  // The data block was cached by the first Get
+  ASSERT_GT(gets[0].perf_counters["block_cache_hit_count"], 0);
+  // Only the counters the operation increased are reported
+  ASSERT_EQ(0, gets[0].perf_counters.count("write_wal_time"));
+
+  auto writes = listener->GetInfos(SlowOperationType::kWrite);
+  ASSERT_EQ(1, writes.size());
+  ASSERT_TRUE(writes[0].cf_name.empty());
+  ASSERT_GE(writes[0].duration_micros, kThresholdMicros);
+  ASSERT_TRUE(writes[0].sst_files.empty());
+
+  Close();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 
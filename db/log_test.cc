@@ -12,6 +12,7 @@
 #include "file/sequence_file_reader.h"
 #include "file/writable_file_writer.h"
 #include "rocksdb/env.h"
+#include "rocksdb/threadpool.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
 #include "util/coding.h"
@@ -181,6 +182,19 @@ class LogTest
 
   Slice* get_reader_contents() { return &reader_contents_; }
 
+  // Replaces the writer with one that compresses large records using
+  // "compression_thread_pool". Must be called before anything is written.
+  void ResetWriter(ThreadPool* compression_thread_pool) {
+    assert(reader_contents_.empty());
+    sink_ = new test::StringSink(&reader_contents_);
+    std::unique_ptr<FSWritableFile> sink_holder(sink_);
+    std::unique_ptr<WritableFileWriter> file_writer(new WritableFileWriter(
+        std::move(sink_holder), "" /* don't care */, FileOptions()));
+    writer_.reset(new Writer(std::move(file_writer), 123,
+                             std::get<0>(GetParam()), false, compression_type_,
+                             compression_thread_pool));
+  }
+
   void Write(const std::string& msg) {
     ASSERT_OK(writer_->AddRecord(Slice(msg)));
   }
@@ -685,6 +699,48 @@ TEST_P(LogTest, Recycle) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(LogTest, SyncRangeCoalescing) {
+  int range_syncs = 0;
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  SyncPoint::GetInstance()->SetCallBack(
+      "WritableFileWriter::RangeSync:0",
+      [&](void* /*arg*/) { ++range_syncs; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  uint64_t offset1 = 0, size1 = 0, offset2 = 0, size2 = 0;
+  ASSERT_OK(writer_->AddRecordWithStartOffsetAndSize(
+      Slice("foo"), Env::IO_TOTAL, true, &offset1, &size1));
+  ASSERT_OK(writer_->AddRecordWithStartOffsetAndSize(
+      Slice("bar"), Env::IO_TOTAL, true, &offset2, &size2));
+  ASSERT_EQ(offset1 + size1, offset2);
+
+  // Syncing the second record also makes the first one durable
+  ASSERT_OK(writer_->SyncRange(false, offset2, size2));
+  ASSERT_EQ(1, range_syncs);
+  ASSERT_EQ(offset2 + size2, writer_->GetSyncedOffset());
+  ASSERT_OK(writer_->SyncRange(false, offset1, size1));
+  ASSERT_EQ(1, range_syncs);
+
+  // A sync for a new record covers everything flushed since the last one
+  Write("baz");
+  uint64_t offset3 = 0, size3 = 0;
+  ASSERT_OK(writer_->AddRecordWithStartOffsetAndSize(
+      Slice("qux"), Env::IO_TOTAL, true, &offset3, &size3));
+  ASSERT_OK(writer_->SyncRange(false, offset3, size3));
+  ASSERT_EQ(2, range_syncs);
+  ASSERT_EQ(WrittenBytes(), writer_->GetSyncedOffset());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ("foo", Read());
+  ASSERT_EQ("bar", Read());
+  ASSERT_EQ("baz", Read());
+  ASSERT_EQ("qux", Read());
+  ASSERT_EQ("EOF", Read());
+}
+
 // Do NOT enable compression for this instantiation.
 INSTANTIATE_TEST_CASE_P(
     Log, LogTest,
@@ -1011,6 +1067,37 @@ TEST_P(CompressionLogTest, AlignedFragmentation) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(CompressionLogTest, ParallelCompression) {
+  CompressionType compression_type = std::get<2>(GetParam());
+  if (!StreamingCompressionTypeSupported(compression_type)) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  std::unique_ptr<ThreadPool> thread_pool(NewThreadPool(2));
+  ResetWriter(thread_pool.get());
+  ASSERT_OK(SetupTestEnv());
+  Random rnd(301);
+  const size_t segment_size = Writer::kParallelCompressionSegmentSize;
+  const std::vector<std::string> wal_entries = {
+      "small",
+      // Compressed on the writing thread
+      rnd.RandomString(static_cast<int>(2 * segment_size - 1)),
+      // Compressed in 2 and 4 segments
+      rnd.RandomString(static_cast<int>(2 * segment_size)),
+      std::string(3 * segment_size + 1, 'x'),
+      "",
+  };
+  for (const std::string& wal_entry : wal_entries) {
+    Write(wal_entry);
+  }
+
+  for (const std::string& wal_entry : wal_entries) {
+    ASSERT_EQ(wal_entry, Read());
+  }
+  ASSERT_EQ("EOF", Read());
+  thread_pool->JoinAllThreads();
+}
+
 INSTANTIATE_TEST_CASE_P(
     Compression, CompressionLogTest,
     ::testing::Combine(::testing::Values(0, 1), ::testing::Bool(),
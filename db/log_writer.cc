@@ -14,22 +14,26 @@
 #include "file/writable_file_writer.h"
 #include "rocksdb/env.h"
 #include "rocksdb/io_status.h"
+#include "rocksdb/threadpool.h"
 #include "util/coding.h"
 #include "util/crc32c.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace log {
 
 Writer::Writer(std::unique_ptr<WritableFileWriter>&& dest, uint64_t log_number,
                bool recycle_log_files, bool manual_flush,
-               CompressionType compression_type)
+               CompressionType compression_type,
+               ThreadPool* compression_thread_pool)
     : dest_(std::move(dest)),
       block_offset_(0),
       log_number_(log_number),
       recycle_log_files_(recycle_log_files),
       manual_flush_(manual_flush),
       compression_type_(compression_type),
-      compress_(nullptr) {
+      compress_(nullptr),
+      compression_thread_pool_(compression_thread_pool) {
   for (int i = 0; i <= kMaxRecordType; i++) {
     char t = static_cast<char>(i);
     type_crc_[i] = crc32c::Value(&t, 1);
@@ -64,6 +68,22 @@ IOStatus Writer::Close() {
 IOStatus Writer::AddRecord(const Slice& slice,
                            Env::IOPriority rate_limiter_priority,
                            bool /*do_flush*/) {
+  if (compress_ != nullptr && compression_thread_pool_ != nullptr &&
+      slice.size() >= 2 * kParallelCompressionSegmentSize) {
+    std::string compressed;
+    IOStatus s = CompressInParallel(slice, &compressed);
+    if (!s.ok()) {
+      return s;
+    }
+    return AddRecordInternal(compressed, nullptr /* compress */,
+                             rate_limiter_priority);
+  }
+  return AddRecordInternal(slice, compress_, rate_limiter_priority);
+}
+
+IOStatus Writer::AddRecordInternal(const Slice& slice,
+                                   StreamingCompress* compress,
+                                   Env::IOPriority rate_limiter_priority) {
   const char* ptr = slice.data();
   size_t left = slice.size();
 
@@ -78,8 +98,8 @@ IOStatus Writer::AddRecord(const Slice& slice,
   bool begin = true;
   int compress_remaining = 0;
   bool compress_start = false;
-  if (compress_) {
-    compress_->Reset();
+  if (compress) {
+    compress->Reset();
     compress_start = true;
   }
   do {
@@ -110,9 +130,9 @@ IOStatus Writer::AddRecord(const Slice& slice,
     // Compress() is called at least once (compress_start=true) and after the
     // previous generated compressed chunk is written out as one or more
     // physical records (left=0).
-    if (compress_ && (compress_start || left == 0)) {
-      compress_remaining = compress_->Compress(slice.data(), slice.size(),
-                                               compressed_buffer_.get(), &left);
+    if (compress && (compress_start || left == 0)) {
+      compress_remaining = compress->Compress(slice.data(), slice.size(),
+                                              compressed_buffer_.get(), &left);
 
       if (compress_remaining < 0) {
         // Set failure status
@@ -158,22 +178,126 @@ IOStatus Writer::AddRecord(const Slice& slice,
   return s;
 }
 
+IOStatus Writer::CompressInParallel(const Slice& slice,
+                                    std::string* compressed) {
+  const size_t num_segments =
+      (slice.size() + kParallelCompressionSegmentSize - 1) /
+      kParallelCompressionSegmentSize;
+  const size_t max_output_buffer_len =
+      kBlockSize - (recycle_log_files_ ? kRecyclableHeaderSize : kHeaderSize);
+  while (segment_compressors_.size() < num_segments) {
+    CompressionOptions opts;
+    constexpr uint32_t compression_format_version = 2;
+    SegmentCompressor compressor;
+    compressor.compress.reset(
+        StreamingCompress::Create(compression_type_, opts,
+                                  compression_format_version,
+                                  max_output_buffer_len));
+    assert(compressor.compress != nullptr);
+    compressor.buffer.reset(new char[max_output_buffer_len]);
+    segment_compressors_.push_back(std::move(compressor));
+  }
+
+  std::vector<std::string> outputs(num_segments);
+  std::unique_ptr<bool[]> succeeded(new bool[num_segments]);
+  auto compress_segment = [&](size_t i) {
+    const size_t offset = i * kParallelCompressionSegmentSize;
+    const size_t length = std::min(kParallelCompressionSegmentSize,
+                                   slice.size() - offset);
+    StreamingCompress* compress = segment_compressors_[i].compress.get();
+    char* buffer = segment_compressors_[i].buffer.get();
+    compress->Reset();
+    int remaining;
+    do {
+      size_t output_size = 0;
+      remaining = compress->Compress(slice.data() + offset, length, buffer,
+                                     &output_size);
+      if (remaining < 0) {
+        succeeded[i] = false;
+        return;
+      }
+      outputs[i].append(buffer, output_size);
+    } while (remaining > 0);
+    succeeded[i] = true;
+  };
+
+  // The calling thread compresses the first segment while the pool handles
+  // the others
+  port::Mutex mutex;
+  port::CondVar cv(&mutex);
+  size_t pending = num_segments - 1;
+  for (size_t i = 1; i < num_segments; ++i) {
+    compression_thread_pool_->SubmitJob([&, i]() {
+      compress_segment(i);
+      MutexLock l(&mutex);
+      if (--pending == 0) {
+        cv.Signal();
+      }
+    });
+  }
+  compress_segment(0);
+  {
+    MutexLock l(&mutex);
+    while (pending > 0) {
+      cv.Wait();
+    }
+  }
+
+  size_t total_size = 0;
+  for (size_t i = 0; i < num_segments; ++i) {
+    if (!succeeded[i]) {
+      IOStatus s = IOStatus::IOError("Unexpected WAL compression error");
+      s.SetDataLoss(true);
+      return s;
+    }
+    total_size += outputs[i].size();
+  }
+  compressed->reserve(total_size);
+  for (const std::string& output : outputs) {
+    compressed->append(output);
+  }
+  return IOStatus::OK();
+}
+
 IOStatus Writer::AddRecordWithStartOffsetAndSize(
     const Slice& slice, Env::IOPriority rate_limiter_priority, bool do_flush,
     uint64_t* offset, uint64_t* size) {
   IOStatus s;
   *offset = dest_->GetFileSize();
   s = AddRecord(slice, rate_limiter_priority, do_flush);
-  *size = dest_->GetFileSize() - *offset + 1;
+  *size = dest_->GetFileSize() - *offset;
   return s;
 }
 
 IOStatus Writer::SyncRange(bool use_fsync, uint64_t offset, uint64_t size) {
+  const uint64_t end_offset = offset + size;
+  if (synced_offset_.load(std::memory_order_acquire) >= end_offset) {
+    // Already made durable by a sync issued for a later write group
+    return IOStatus::OK();
+  }
+
+  MutexLock l(&sync_mutex_);
+  const uint64_t synced_offset = synced_offset_.load(std::memory_order_relaxed);
+  if (synced_offset >= end_offset) {
+    // The sync we waited for covered this range too
+    TEST_SYNC_POINT("LogWriter::SyncRange:Coalesced");
+    return IOStatus::OK();
+  }
+
   IOStatus s;
+  uint64_t new_synced_offset;
   if (!manual_flush_) {
-    s = dest_->RangeSync(offset, size);
+    // Everything flushed so far is synced, including the write groups that
+    // were appended while we were waiting for the previous sync
+    new_synced_offset = dest_->GetFlushedSize();
+    assert(new_synced_offset >= end_offset);
+    s = dest_->RangeSync(synced_offset, new_synced_offset - synced_offset);
   } else {
     s = dest_->Sync(use_fsync);
+    new_synced_offset = dest_->GetFileSize();
+  }
+  if (s.ok()) {
+    synced_offset_.store(new_synced_offset, std::memory_order_release);
   }
   return s;
 }
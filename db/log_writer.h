@@ -8,10 +8,14 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "db/log_format.h"
+#include "port/port.h"
 #include "rocksdb/compression_type.h"
 #include "rocksdb/env.h"
 #include "rocksdb/io_status.h"
@@ -21,6 +25,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class ThreadPool;
 class WritableFileWriter;
 
 namespace log {
@@ -70,13 +75,20 @@ namespace log {
  */
 class Writer {
  public:
+  // Records of at least twice this size are split into segments of this size
+  // that are compressed concurrently when a compression thread pool is set.
+  static constexpr size_t kParallelCompressionSegmentSize = 1 << 20;
+
   // Create a writer that will append data to "*dest".
   // "*dest" must be initially empty.
   // "*dest" must remain live while this Writer is in use.
+  // If "compression_thread_pool" is not null, it is used to compress large
+  // records off the calling thread. It must outlive this Writer.
   explicit Writer(std::unique_ptr<WritableFileWriter>&& dest,
                   uint64_t log_number, bool recycle_log_files,
                   bool manual_flush = false,
-                  CompressionType compressionType = kNoCompression);
+                  CompressionType compressionType = kNoCompression,
+                  ThreadPool* compression_thread_pool = nullptr);
   // No copying allowed
   Writer(const Writer&) = delete;
   void operator=(const Writer&) = delete;
@@ -91,6 +103,13 @@ class Writer {
       bool do_flush = true, uint64_t* offset = nullptr,
       uint64_t* size = nullptr);
 
+  // Makes the log content in [offset, offset + size) durable. Concurrent
+  // callers are coalesced: a range already covered by a completed sync
+  // returns immediately, and a sync issued while others wait covers
+  // everything flushed so far, so a single sync can serve several write
+  // groups. Without manual_flush, this may run concurrently with
+  // AddRecord(); with manual_flush, the caller must serialize it with
+  // writes.
   IOStatus SyncRange(bool use_fsync, uint64_t offset, uint64_t size);
   IOStatus AddCompressionTypeRecord();
 
@@ -105,6 +124,12 @@ class Writer {
 
   bool BufferIsEmpty();
 
+  // Returns the offset up to which the log is known to be durable through
+  // SyncRange().
+  uint64_t GetSyncedOffset() const {
+    return synced_offset_.load(std::memory_order_acquire);
+  }
+
  private:
   std::unique_ptr<WritableFileWriter> dest_;
   size_t block_offset_;  // Current offset in block
@@ -120,6 +145,16 @@ class Writer {
       RecordType type, const char* ptr, size_t length,
       Env::IOPriority rate_limiter_priority = Env::IO_TOTAL);
 
+  // Fragments "slice" into physical records. If "compress" is not null, the
+  // payload is compressed with it on the fly, otherwise it is written as is.
+  IOStatus AddRecordInternal(const Slice& slice, StreamingCompress* compress,
+                             Env::IOPriority rate_limiter_priority);
+
+  // Compresses "slice" into "*compressed" as a sequence of independent
+  // compression frames, one per segment, using compression_thread_pool_.
+  // The log reader decompresses the frames as a single stream.
+  IOStatus CompressInParallel(const Slice& slice, std::string* compressed);
+
   // If true, it does not flush after each write. Instead it relies on the upper
   // layer to manually does the flush by calling ::WriteBuffer()
   bool manual_flush_;
@@ -129,6 +164,20 @@ class Writer {
   StreamingCompress* compress_;
   // Reusable compressed output buffer
   std::unique_ptr<char[]> compressed_buffer_;
+
+  ThreadPool* compression_thread_pool_;
+  // Compression contexts and output buffers used for the segments of a
+  // record compressed in parallel. Grown on demand and reused across records.
+  struct SegmentCompressor {
+    std::unique_ptr<StreamingCompress> compress;
+    std::unique_ptr<char[]> buffer;
+  };
+  std::vector<SegmentCompressor> segment_compressors_;
+
+  // Serializes SyncRange() callers, so that only one sync is in flight while
+  // later write groups keep appending.
+  port::Mutex sync_mutex_;
+  std::atomic<uint64_t> synced_offset_{0};
 };
 
 }  // namespace log
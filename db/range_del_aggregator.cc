@@ -350,6 +350,49 @@ bool ReadRangeDelAggregator::ShouldDeleteImpl(const ParsedInternalKey& parsed,
   return rep_.ShouldDelete(parsed, mode);
 }
 
+bool RangeDelAggregator::StripeRep::IsRangeCovered(
+    const Slice& start, const Slice& end, SequenceNumber smallest_seqno,
+    SequenceNumber largest_seqno) {
+  if (IsEmpty() || !InStripe(smallest_seqno) || !InStripe(largest_seqno)) {
+    return false;
+  }
+  Invalidate();
+
+  const Comparator* ucmp = icmp_->user_comparator();
+  Slice pos = start;
+  while (true) {
+    // The smallest internal key with user key `pos` the range can contain.
+    const ParsedInternalKey pos_ikey(pos, largest_seqno, kValueTypeForSeek);
+    bool found = false;
+    ParsedInternalKey furthest_end;
+    for (auto& iter : iters_) {
+      iter->Seek(pos);
+      // Seek() lands on the newest tombstone covering `pos`, if any.
+      if (!iter->Valid() || iter->seq() <= largest_seqno ||
+          icmp_->Compare(iter->start_key(), pos_ikey) > 0) {
+        continue;
+      }
+      const ParsedInternalKey end_key = iter->end_key();
+      if (!found || icmp_->Compare(end_key, furthest_end) > 0) {
+        furthest_end = end_key;
+        found = true;
+      }
+    }
+    if (!found) {
+      return false;
+    }
+    if (ucmp->Compare(furthest_end.user_key, end) > 0) {
+      return true;
+    }
+    if (ucmp->Compare(furthest_end.user_key, pos) <= 0) {
+      // The tombstone was truncated inside `pos`, give up rather than reason
+      // about sequence numbers at the truncation point.
+      return false;
+    }
+    pos = furthest_end.user_key;
+  }
+}
+
 bool ReadRangeDelAggregator::IsRangeOverlapped(const Slice& start,
                                                const Slice& end) {
   InvalidateRangeDelMapPositions();
@@ -413,6 +456,21 @@ bool CompactionRangeDelAggregator::ShouldDelete(const ParsedInternalKey& parsed,
   return it->second.ShouldDelete(parsed, mode);
 }
 
+bool CompactionRangeDelAggregator::IsRangeCovered(
+    const Slice& start, const Slice& end, SequenceNumber smallest_seqno,
+    SequenceNumber largest_seqno) {
+  if (icmp_->user_comparator()->timestamp_size() > 0) {
+    return false;
+  }
+  // A tombstone only deletes keys of its own snapshot stripe, so the whole
+  // sequence number range has to fall into a single stripe.
+  auto it = reps_.lower_bound(smallest_seqno);
+  if (it == reps_.end()) {
+    return false;
+  }
+  return it->second.IsRangeCovered(start, end, smallest_seqno, largest_seqno);
+}
+
 namespace {
 
 // Produce a sorted (by start internal key) stream of range tombstones from
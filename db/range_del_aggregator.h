@@ -346,6 +346,13 @@ class RangeDelAggregator {
     // with timestamp.
     bool IsRangeOverlapped(const Slice& start, const Slice& end);
 
+    // Returns true if every key with a user key in [start, end] and a sequence
+    // number in [smallest_seqno, largest_seqno] would be deleted by the
+    // tombstones of this stripe.
+    bool IsRangeCovered(const Slice& start, const Slice& end,
+                        SequenceNumber smallest_seqno,
+                        SequenceNumber largest_seqno);
+
    private:
     bool InStripe(SequenceNumber seq) const {
       return lower_bound_ <= seq && seq <= upper_bound_;
@@ -439,6 +446,16 @@ class CompactionRangeDelAggregator : public RangeDelAggregator {
 
   bool IsRangeOverlapped(const Slice& start, const Slice& end);
 
+  // Returns true if the tombstones added so far delete every key with a user
+  // key in [start, end] (both inclusive) and a sequence number in
+  // [smallest_seqno, largest_seqno], i.e. if ShouldDelete() would return true
+  // for all of them. Used to drop compaction input files whose whole content
+  // is covered by a newer range tombstone without reading them. Always false
+  // when user-defined timestamps are enabled.
+  bool IsRangeCovered(const Slice& start, const Slice& end,
+                      SequenceNumber smallest_seqno,
+                      SequenceNumber largest_seqno);
+
   void InvalidateRangeDelMapPositions() override {
     for (auto& rep : reps_) {
       rep.second.Invalidate();
@@ -17,6 +17,7 @@
 #include "file/filename.h"
 #include "file/random_access_file_reader.h"
 #include "monitoring/perf_context_imp.h"
+#include "monitoring/slow_operation_tracker.h"
 #include "rocksdb/advanced_options.h"
 #include "rocksdb/statistics.h"
 #include "table/block_based/block_based_table_reader.h"
@@ -217,6 +218,7 @@ InternalIterator* TableCache::NewIterator(
     const InternalKey* largest_compaction_key, bool allow_unprepared_value,
     TruncatedRangeDelIterator** range_del_iter) {
   PERF_TIMER_GUARD(new_table_iterator_nanos);
+  SlowOperationTracker::RecordFileRead(file_meta.fd.GetNumber());
 
   Status s;
   TableReader* table_reader = nullptr;
@@ -410,6 +412,7 @@ Status TableCache::Get(
     HistogramImpl* file_read_hist, bool skip_filters, int level,
     size_t max_file_size_for_l0_meta_pin) {
   auto& fd = file_meta.fd;
+  SlowOperationTracker::RecordFileRead(fd.GetNumber());
   std::string* row_cache_entry = nullptr;
   bool done = false;
   IterKey row_cache_key;
@@ -21,6 +21,7 @@ DEFINE_SYNC_AND_ASYNC(Status, TableCache::MultiGet)
  HistogramImpl* file_read_hist, bool skip_filters, bool skip_range_deletions,
  int level, TypedHandle* handle) {
   auto& fd = file_meta.fd;
+  SlowOperationTracker::RecordFileRead(fd.GetNumber());
   Status s;
   TableReader* t = fd.table_reader;
   MultiGetRange table_range(*mget_range, mget_range->begin(),
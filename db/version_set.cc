@@ -50,6 +50,7 @@
 #include "file/writable_file_writer.h"
 #include "logging/logging.h"
 #include "monitoring/file_read_sample.h"
+#include "monitoring/iostats_context_imp.h"
 #include "monitoring/perf_context_imp.h"
 #include "monitoring/persistent_stats_history.h"
 #include "options/options_helper.h"
@@ -2304,6 +2305,8 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
                 &storage_info_.file_indexer_, user_comparator(),
                 internal_comparator());
   FdWithKeyRange* f = fp.GetNextFile();
+  CFOperationStats* cf_op_stats =
+      cfd_->internal_stats()->GetCFOperationStats();
 
   while (f != nullptr) {
     if (*max_covering_tombstone_seq > 0) {
@@ -2319,6 +2322,8 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
         GetPerfLevel() >= PerfLevel::kEnableTimeExceptForMutex &&
         get_perf_context()->per_level_perf_context_enabled;
     StopWatchNano timer(clock_, timer_enabled /* auto_start */);
+    const uint64_t bytes_read_before =
+        cf_op_stats != nullptr ? IOSTATS(bytes_read) : 0;
     *status = table_cache_->Get(
         read_options, *internal_comparator(), *f->file_metadata, ikey,
         &get_context, mutable_cf_options_.prefix_extractor,
@@ -2331,6 +2336,10 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
       PERF_COUNTER_BY_LEVEL_ADD(get_from_table_nanos, timer.ElapsedNanos(),
                                 fp.GetHitFileLevel());
     }
+    if (cf_op_stats != nullptr) {
+      cf_op_stats->AddBytesRead(fp.GetHitFileLevel(),
+                                IOSTATS(bytes_read) - bytes_read_before);
+    }
     if (!status->ok()) {
       if (db_statistics_ != nullptr) {
         get_context.ReportCounters();
@@ -3437,7 +3446,8 @@ void VersionStorageInfo::ComputeCompactionScore(
       mutable_cf_options.blob_garbage_collection_force_threshold < 1.0) {
     ComputeFilesMarkedForForcedBlobGC(
         mutable_cf_options.blob_garbage_collection_age_cutoff,
-        mutable_cf_options.blob_garbage_collection_force_threshold);
+        mutable_cf_options.blob_garbage_collection_force_threshold,
+        mutable_cf_options.blob_garbage_collection_force_max_batches);
   }
 
   EstimateCompactionBytesNeeded(mutable_cf_options);
@@ -3551,7 +3561,8 @@ void VersionStorageInfo::ComputeFilesMarkedForPeriodicCompaction(
 
 void VersionStorageInfo::ComputeFilesMarkedForForcedBlobGC(
     double blob_garbage_collection_age_cutoff,
-    double blob_garbage_collection_force_threshold) {
+    double blob_garbage_collection_force_threshold,
+    uint32_t blob_garbage_collection_force_max_batches) {
   files_marked_for_forced_blob_gc_.clear();
 
   if (blob_files_.empty()) {
@@ -3565,9 +3576,9 @@ void VersionStorageInfo::ComputeFilesMarkedForForcedBlobGC(
     return;
   }
 
-  // Compute the sum of total and garbage bytes over the oldest batch of blob
-  // files. The oldest batch is defined as the set of blob files which are
-  // kept alive by the same SSTs as the very oldest one. Here is a toy example.
+  // Compute the sum of total and garbage bytes over the oldest batches of blob
+  // files. A batch is defined as the set of blob files which are kept alive by
+  // the same SSTs as the oldest blob file of the batch. Here is a toy example.
   // Let's assume we have three SSTs 1, 2, and 3, and four blob files 10, 11,
   // 12, and 13. Also, let's say SSTs 1 and 2 both rely on blob file 10 and
   // potentially some higher-numbered ones, while SST 3 relies on blob file 12
@@ -3590,68 +3601,81 @@ void VersionStorageInfo::ComputeFilesMarkedForForcedBlobGC(
   //
   // Then, the oldest batch of blob files consists of blob files 10 and 11,
   // and we can get rid of them by forcing the compaction of SSTs 1 and 2.
+  // Similarly, the two oldest batches (blob files 10 to 13) can be eliminated
+  // by compacting SSTs 1, 2, and 3, since any SST referencing one of these blob
+  // files is linked to one of them.
   //
-  // Note that the overall ratio of garbage computed for the batch has to exceed
-  // blob_garbage_collection_force_threshold and the entire batch has to be
-  // eligible for GC according to blob_garbage_collection_age_cutoff in order
-  // for us to schedule any compactions.
-  const auto& oldest_meta = blob_files_.front();
-  assert(oldest_meta);
-
-  const auto& linked_ssts = oldest_meta->GetLinkedSsts();
-  assert(!linked_ssts.empty());
+  // We pick the longest run of oldest batches, at most
+  // blob_garbage_collection_force_max_batches of them, whose overall ratio of
+  // garbage meets blob_garbage_collection_force_threshold, and which are
+  // entirely eligible for GC according to blob_garbage_collection_age_cutoff.
+  // A newer batch with a high ratio of garbage is thus only collected if its
+  // garbage makes up for the valid blobs of the older batches of the run.
+  assert(cutoff_count <= blob_files_.size());
 
-  size_t count = 1;
-  uint64_t sum_total_blob_bytes = oldest_meta->GetTotalBlobBytes();
-  uint64_t sum_garbage_blob_bytes = oldest_meta->GetGarbageBlobBytes();
+  uint64_t sum_total_blob_bytes = 0;
+  uint64_t sum_garbage_blob_bytes = 0;
+  size_t gc_count = 0;
+  uint32_t num_batches = 0;
+
+  for (size_t batch_begin = 0;
+       batch_begin < cutoff_count &&
+       (blob_garbage_collection_force_max_batches == 0 ||
+        num_batches < blob_garbage_collection_force_max_batches);
+       ++num_batches) {
+    const auto& oldest_meta = blob_files_[batch_begin];
+    assert(oldest_meta);
+    assert(!oldest_meta->GetLinkedSsts().empty());
+
+    sum_total_blob_bytes += oldest_meta->GetTotalBlobBytes();
+    sum_garbage_blob_bytes += oldest_meta->GetGarbageBlobBytes();
+
+    size_t batch_end = batch_begin + 1;
+    for (; batch_end < blob_files_.size(); ++batch_end) {
+      const auto& meta = blob_files_[batch_end];
+      assert(meta);
 
-  assert(cutoff_count <= blob_files_.size());
+      if (!meta->GetLinkedSsts().empty()) {
+        // Found the beginning of the next batch of blob files
+        break;
+      }
 
-  for (; count < cutoff_count; ++count) {
-    const auto& meta = blob_files_[count];
-    assert(meta);
+      sum_total_blob_bytes += meta->GetTotalBlobBytes();
+      sum_garbage_blob_bytes += meta->GetGarbageBlobBytes();
+    }
 
-    if (!meta->GetLinkedSsts().empty()) {
-      // Found the beginning of the next batch of blob files
+    if (batch_end > cutoff_count) {
+      // Some files in this batch are not eligible for GC
       break;
     }
 
-    sum_total_blob_bytes += meta->GetTotalBlobBytes();
-    sum_garbage_blob_bytes += meta->GetGarbageBlobBytes();
-  }
-
-  if (count < blob_files_.size()) {
-    const auto& meta = blob_files_[count];
-    assert(meta);
-
-    if (meta->GetLinkedSsts().empty()) {
-      // Some files in the oldest batch are not eligible for GC
-      return;
+    if (sum_garbage_blob_bytes >=
+        blob_garbage_collection_force_threshold * sum_total_blob_bytes) {
+      gc_count = batch_end;
     }
-  }
 
-  if (sum_garbage_blob_bytes <
-      blob_garbage_collection_force_threshold * sum_total_blob_bytes) {
-    return;
+    batch_begin = batch_end;
   }
 
-  for (uint64_t sst_file_number : linked_ssts) {
-    const FileLocation location = GetFileLocation(sst_file_number);
-    assert(location.IsValid());
+  for (size_t i = 0; i < gc_count; ++i) {
+    for (uint64_t sst_file_number : blob_files_[i]->GetLinkedSsts()) {
+      const FileLocation location = GetFileLocation(sst_file_number);
+      assert(location.IsValid());
 
-    const int level = location.GetLevel();
-    assert(level >= 0);
+      const int level = location.GetLevel();
+      assert(level >= 0);
 
-    const size_t pos = location.GetPosition();
+      const size_t pos = location.GetPosition();
 
-    FileMetaData* const sst_meta = files_[level][pos];
-    assert(sst_meta);
+      FileMetaData* const sst_meta = files_[level][pos];
+      assert(sst_meta);
 
-    if (sst_meta->being_compacted) {
-      continue;
-    }
+      if (sst_meta->being_compacted) {
+        continue;
+      }
 
-    files_marked_for_forced_blob_gc_.emplace_back(level, sst_meta);
+      files_marked_for_forced_blob_gc_.emplace_back(level, sst_meta);
+    }
   }
 }
 
@@ -6626,9 +6650,15 @@ void VersionSet::AddLiveFiles(std::vector<uint64_t>* live_table_files,
   }
 }
 
+struct VersionSet::FilteredInputLevel {
+  LevelFilesBrief flevel;
+  std::vector<FdWithKeyRange> files;
+  std::vector<AtomicCompactionUnitBoundary> boundaries;
+};
+
 InternalIterator* VersionSet::MakeInputIterator(
     const ReadOptions& read_options, const Compaction* c,
-    RangeDelAggregator* range_del_agg,
+    CompactionRangeDelAggregator* range_del_agg,
     const FileOptions& file_options_compactions,
     const std::optional<const Slice>& start,
     const std::optional<const Slice>& end) {
@@ -6648,6 +6678,9 @@ InternalIterator* VersionSet::MakeInputIterator(
   std::vector<
       std::pair<TruncatedRangeDelIterator*, TruncatedRangeDelIterator***>>
       range_tombstones;
+  // Input levels without the files that are fully covered by range tombstones
+  // of the levels above, owned by the returned iterator.
+  std::vector<FilteredInputLevel*> filtered_levels;
   size_t num = 0;
   for (size_t which = 0; which < c->num_input_levels(); which++) {
     if (c->input_levels(which)->num_files != 0) {
@@ -6686,18 +6719,38 @@ InternalIterator* VersionSet::MakeInputIterator(
           range_tombstones.emplace_back(range_tombstone_iter, nullptr);
         }
       } else {
-        // Create concatenating iterator for the files from this level
-        TruncatedRangeDelIterator*** tombstone_iter_ptr = nullptr;
-        list[num++] = new LevelIterator(
-            cfd->table_cache(), read_options, file_options_compactions,
-            cfd->internal_comparator(), c->input_levels(which),
-            c->mutable_cf_options()->prefix_extractor,
-            /*should_sample=*/false,
-            /*no per level latency histogram=*/nullptr,
-            TableReaderCaller::kCompaction, /*skip_filters=*/false,
-            /*level=*/static_cast<int>(c->level(which)), range_del_agg,
-            c->boundaries(which), false, &tombstone_iter_ptr);
-        range_tombstones.emplace_back(nullptr, tombstone_iter_ptr);
+        const LevelFilesBrief* flevel = c->input_levels(which);
+        const std::vector<AtomicCompactionUnitBoundary>* boundaries =
+            c->boundaries(which);
+        if (which > 0) {
+          FilteredInputLevel* filtered = FilterCoveredInputFiles(
+              read_options, c, which, range_del_agg);
+          if (filtered != nullptr) {
+            filtered_levels.push_back(filtered);
+            flevel = &filtered->flevel;
+            boundaries = &filtered->boundaries;
+          }
+        }
+        // All the files of the level may be covered
+        if (flevel->num_files != 0) {
+          // Create concatenating iterator for the files from this level
+          TruncatedRangeDelIterator*** tombstone_iter_ptr = nullptr;
+          list[num++] = new LevelIterator(
+              cfd->table_cache(), read_options, file_options_compactions,
+              cfd->internal_comparator(), flevel,
+              c->mutable_cf_options()->prefix_extractor,
+              /*should_sample=*/false,
+              /*no per level latency histogram=*/nullptr,
+              TableReaderCaller::kCompaction, /*skip_filters=*/false,
+              /*level=*/static_cast<int>(c->level(which)), range_del_agg,
+              boundaries, false, &tombstone_iter_ptr);
+          range_tombstones.emplace_back(nullptr, tombstone_iter_ptr);
+        }
+        if (which + 1 < c->num_input_levels()) {
+          // Make the tombstones of this level visible to
+          // FilterCoveredInputFiles() for the levels below.
+          AddInputLevelTombstones(read_options, c, which, range_del_agg);
+        }
       }
     }
   }
@@ -6706,9 +6759,98 @@ InternalIterator* VersionSet::MakeInputIterator(
       &c->column_family_data()->internal_comparator(), list,
       static_cast<int>(num), range_tombstones);
   delete[] list;
+  for (FilteredInputLevel* filtered : filtered_levels) {
+    result->RegisterCleanup(
+        [](void* arg1, void* /*arg2*/) {
+          delete static_cast<FilteredInputLevel*>(arg1);
+        },
+        filtered, nullptr);
+  }
   return result;
 }
 
+void VersionSet::AddInputLevelTombstones(
+    const ReadOptions& read_options, const Compaction* c, size_t which,
+    CompactionRangeDelAggregator* range_del_agg) {
+  auto cfd = c->column_family_data();
+  const LevelFilesBrief* flevel = c->input_levels(which);
+  const std::vector<AtomicCompactionUnitBoundary>* boundaries =
+      c->boundaries(which);
+  for (size_t i = 0; i < flevel->num_files; i++) {
+    const FileMetaData& fmd = *flevel->files[i].file_metadata;
+    std::unique_ptr<FragmentedRangeTombstoneIterator> tombstone_iter;
+    if (!cfd->table_cache()
+             ->GetRangeTombstoneIterator(read_options,
+                                         cfd->internal_comparator(), fmd,
+                                         &tombstone_iter)
+             .ok() ||
+        tombstone_iter == nullptr || tombstone_iter->empty()) {
+      // Errors surface when the LevelIterator opens the file. Leaving the
+      // file unregistered lets it add the tombstones then.
+      continue;
+    }
+    if (!range_del_agg->AddFile(fmd.fd.GetNumber())) {
+      continue;
+    }
+    // Same truncation bounds as LevelIterator::NewFileIterator()
+    const InternalKey* smallest = &fmd.smallest;
+    const InternalKey* largest = &fmd.largest;
+    if (boundaries != nullptr && i < boundaries->size()) {
+      smallest = (*boundaries)[i].smallest;
+      largest = (*boundaries)[i].largest;
+    }
+    range_del_agg->AddTombstones(std::move(tombstone_iter), smallest, largest);
+  }
+}
+
+VersionSet::FilteredInputLevel* VersionSet::FilterCoveredInputFiles(
+    const ReadOptions& read_options, const Compaction* c, size_t which,
+    CompactionRangeDelAggregator* range_del_agg) {
+  if (range_del_agg->IsEmpty() || read_options.ignore_range_deletions) {
+    return nullptr;
+  }
+  const LevelFilesBrief* flevel = c->input_levels(which);
+  const std::vector<AtomicCompactionUnitBoundary>* boundaries =
+      c->boundaries(which);
+  std::unique_ptr<FilteredInputLevel> filtered;
+  for (size_t i = 0; i < flevel->num_files; i++) {
+    const FileMetaData& fmd = *flevel->files[i].file_metadata;
+    // Keys referencing blobs are needed to account for the garbage they
+    // leave in their blob files.
+    if (fmd.oldest_blob_file_number == kInvalidBlobFileNumber &&
+        range_del_agg->IsRangeCovered(fmd.smallest.user_key(),
+                                      fmd.largest.user_key(),
+                                      fmd.fd.smallest_seqno,
+                                      fmd.fd.largest_seqno)) {
+      TEST_SYNC_POINT_CALLBACK("VersionSet::MakeInputIterator:SkipCoveredFile",
+                               const_cast<FileMetaData*>(&fmd));
+      if (!filtered) {
+        filtered.reset(new FilteredInputLevel);
+        filtered->files.reserve(flevel->num_files);
+        for (size_t j = 0; j < i; j++) {
+          filtered->files.push_back(flevel->files[j]);
+          if (boundaries != nullptr && j < boundaries->size()) {
+            filtered->boundaries.push_back((*boundaries)[j]);
+          }
+        }
+      }
+      continue;
+    }
+    if (filtered) {
+      filtered->files.push_back(flevel->files[i]);
+      if (boundaries != nullptr && i < boundaries->size()) {
+        filtered->boundaries.push_back((*boundaries)[i]);
+      }
+    }
+  }
+  if (!filtered) {
+    return nullptr;
+  }
+  filtered->flevel.num_files = filtered->files.size();
+  filtered->flevel.files = filtered->files.data();
+  return filtered.release();
+}
+
 Status VersionSet::GetMetadataForFile(uint64_t number, int* filelevel,
                                       FileMetaData** meta,
                                       ColumnFamilyData** cfd) {
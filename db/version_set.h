@@ -235,7 +235,8 @@ class VersionStorageInfo {
   // REQUIRES: DB mutex held
   void ComputeFilesMarkedForForcedBlobGC(
       double blob_garbage_collection_age_cutoff,
-      double blob_garbage_collection_force_threshold);
+      double blob_garbage_collection_force_threshold,
+      uint32_t blob_garbage_collection_force_max_batches);
 
   bool level0_non_overlapping() const { return level0_non_overlapping_; }
 
@@ -1401,9 +1402,12 @@ class VersionSet {
   // The caller should delete the iterator when no longer needed.
   // @param read_options Must outlive the returned iterator.
   // @param start, end indicates compaction range
+  // Input files of a non-L0 level that are entirely covered by range
+  // tombstones of the input levels above it, in the same snapshot stripe, are
+  // left out of the iterator since compaction would drop all their keys.
   InternalIterator* MakeInputIterator(
       const ReadOptions& read_options, const Compaction* c,
-      RangeDelAggregator* range_del_agg,
+      CompactionRangeDelAggregator* range_del_agg,
       const FileOptions& file_options_compactions,
       const std::optional<const Slice>& start,
       const std::optional<const Slice>& end);
@@ -1621,6 +1625,22 @@ class VersionSet {
   Status LogAndApplyHelper(ColumnFamilyData* cfd, VersionBuilder* b,
                            VersionEdit* edit, SequenceNumber* max_last_sequence,
                            InstrumentedMutex* mu);
+
+  // A compaction input level with some of its files left out.
+  struct FilteredInputLevel;
+
+  // Adds the range tombstones of the files of input level `which` of `c` to
+  // `range_del_agg` ahead of the LevelIterator opening them.
+  void AddInputLevelTombstones(const ReadOptions& read_options,
+                               const Compaction* c, size_t which,
+                               CompactionRangeDelAggregator* range_del_agg);
+
+  // Returns input level `which` of `c` without the files whose keys are all
+  // covered by the tombstones in `range_del_agg`, or nullptr if no file is
+  // covered. The caller owns the result.
+  FilteredInputLevel* FilterCoveredInputFiles(
+      const ReadOptions& read_options, const Compaction* c, size_t which,
+      CompactionRangeDelAggregator* range_del_agg);
 };
 
 // ReactiveVersionSet represents a collection of versions of the column
@@ -23,6 +23,10 @@ DEFINE_SYNC_AND_ASYNC(Status, Version::MultiGetFromSST)
 
   Status s;
   StopWatchNano timer(clock_, timer_enabled /* auto_start */);
+  CFOperationStats* cf_op_stats =
+      cfd_->internal_stats()->GetCFOperationStats();
+  const uint64_t bytes_read_before =
+      cf_op_stats != nullptr ? IOSTATS(bytes_read) : 0;
   s = CO_AWAIT(table_cache_->MultiGet)(
       read_options, *internal_comparator(), *f->file_metadata, &file_range,
       mutable_cf_options_.prefix_extractor,
@@ -33,6 +37,12 @@ DEFINE_SYNC_AND_ASYNC(Status, Version::MultiGetFromSST)
     PERF_COUNTER_BY_LEVEL_ADD(get_from_table_nanos, timer.ElapsedNanos(),
                               hit_file_level);
   }
+  if (cf_op_stats != nullptr) {
+    // With coroutines, reads of other files may be interleaved. The bytes
+    // they read are counted here too.
+    cf_op_stats->AddBytesRead(hit_file_level,
+                              IOSTATS(bytes_read) - bytes_read_before);
+  }
   if (!s.ok()) {
     // TODO: Set status for individual keys appropriately
     for (auto iter = file_range.begin(); iter != file_range.end(); ++iter) {
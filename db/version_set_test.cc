@@ -549,7 +549,9 @@ TEST_F(VersionStorageInfoTest, ForcedBlobGCEmpty) {
 
   constexpr double age_cutoff = 0.5;
   constexpr double force_threshold = 0.75;
-  vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold);
+  constexpr uint32_t max_batches = 1;
+  vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
 
   ASSERT_TRUE(vstorage_.FilesMarkedForForcedBlobGC().empty());
 }
@@ -633,7 +635,9 @@ TEST_F(VersionStorageInfoTest, ForcedBlobGCSingleBatch) {
   {
     constexpr double age_cutoff = 0.1;
     constexpr double force_threshold = 0.0;
-    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold);
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
 
     ASSERT_TRUE(vstorage_.FilesMarkedForForcedBlobGC().empty());
   }
@@ -644,7 +648,9 @@ TEST_F(VersionStorageInfoTest, ForcedBlobGCSingleBatch) {
   {
     constexpr double age_cutoff = 0.5;
     constexpr double force_threshold = 0.0;
-    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold);
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
 
     ASSERT_TRUE(vstorage_.FilesMarkedForForcedBlobGC().empty());
   }
@@ -655,7 +661,9 @@ TEST_F(VersionStorageInfoTest, ForcedBlobGCSingleBatch) {
   {
     constexpr double age_cutoff = 1.0;
     constexpr double force_threshold = 0.6;
-    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold);
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
 
     ASSERT_TRUE(vstorage_.FilesMarkedForForcedBlobGC().empty());
   }
@@ -666,7 +674,9 @@ TEST_F(VersionStorageInfoTest, ForcedBlobGCSingleBatch) {
   {
     constexpr double age_cutoff = 1.0;
     constexpr double force_threshold = 0.5;
-    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold);
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
 
     auto ssts_to_be_compacted = vstorage_.FilesMarkedForForcedBlobGC();
     ASSERT_EQ(ssts_to_be_compacted.size(), 1);
@@ -780,7 +790,9 @@ TEST_F(VersionStorageInfoTest, ForcedBlobGCMultipleBatches) {
   {
     constexpr double age_cutoff = 0.1;
     constexpr double force_threshold = 0.0;
-    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold);
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
 
     ASSERT_TRUE(vstorage_.FilesMarkedForForcedBlobGC().empty());
   }
@@ -791,7 +803,9 @@ TEST_F(VersionStorageInfoTest, ForcedBlobGCMultipleBatches) {
   {
     constexpr double age_cutoff = 0.25;
     constexpr double force_threshold = 0.0;
-    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold);
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
 
     ASSERT_TRUE(vstorage_.FilesMarkedForForcedBlobGC().empty());
   }
@@ -802,7 +816,9 @@ TEST_F(VersionStorageInfoTest, ForcedBlobGCMultipleBatches) {
   {
     constexpr double age_cutoff = 0.5;
     constexpr double force_threshold = 0.6;
-    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold);
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
 
     ASSERT_TRUE(vstorage_.FilesMarkedForForcedBlobGC().empty());
   }
@@ -813,7 +829,9 @@ TEST_F(VersionStorageInfoTest, ForcedBlobGCMultipleBatches) {
   {
     constexpr double age_cutoff = 0.5;
     constexpr double force_threshold = 0.5;
-    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold);
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
 
     auto ssts_to_be_compacted = vstorage_.FilesMarkedForForcedBlobGC();
     ASSERT_EQ(ssts_to_be_compacted.size(), 2);
@@ -842,7 +860,9 @@ TEST_F(VersionStorageInfoTest, ForcedBlobGCMultipleBatches) {
   {
     constexpr double age_cutoff = 0.75;
     constexpr double force_threshold = 0.6;
-    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold);
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
 
     ASSERT_TRUE(vstorage_.FilesMarkedForForcedBlobGC().empty());
   }
@@ -853,7 +873,128 @@ TEST_F(VersionStorageInfoTest, ForcedBlobGCMultipleBatches) {
   {
     constexpr double age_cutoff = 0.75;
     constexpr double force_threshold = 0.5;
-    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold);
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
+
+    auto ssts_to_be_compacted = vstorage_.FilesMarkedForForcedBlobGC();
+    ASSERT_EQ(ssts_to_be_compacted.size(), 2);
+
+    std::sort(ssts_to_be_compacted.begin(), ssts_to_be_compacted.end(),
+              [](const std::pair<int, FileMetaData*>& lhs,
+                 const std::pair<int, FileMetaData*>& rhs) {
+                assert(lhs.second);
+                assert(rhs.second);
+                return lhs.second->fd.GetNumber() < rhs.second->fd.GetNumber();
+              });
+
+    const autovector<std::pair<int, FileMetaData*>>
+        expected_ssts_to_be_compacted{{level, level_files[0]},
+                                      {level, level_files[1]}};
+
+    ASSERT_EQ(ssts_to_be_compacted[0], expected_ssts_to_be_compacted[0]);
+    ASSERT_EQ(ssts_to_be_compacted[1], expected_ssts_to_be_compacted[1]);
+  }
+}
+
+TEST_F(VersionStorageInfoTest, ForcedBlobGCOldestBatchMostlyValid) {
+  // Add two L0 SSTs (1 and 2) and four blob files (10, 11, 12, and 13). SST 1
+  // keeps blob files 10 and 11 alive, SST 2 keeps blob files 12 and 13 alive.
+  // The oldest batch contains 10% garbage, the second one 90%, so the two
+  // batches together contain 50% garbage.
+
+  constexpr int level = 0;
+
+  constexpr uint64_t first_sst = 1;
+  constexpr uint64_t second_sst = 2;
+
+  constexpr uint64_t first_blob = 10;
+  constexpr uint64_t second_blob = 11;
+  constexpr uint64_t third_blob = 12;
+  constexpr uint64_t fourth_blob = 13;
+
+  Add(level, first_sst, "bar1", "foo1", 1000, first_blob);
+  Add(level, second_sst, "bar2", "foo2", 2000, third_blob);
+
+  AddBlob(first_blob, 10, 1000, BlobFileMetaData::LinkedSsts{first_sst}, 1,
+          100);
+  AddBlob(second_blob, 10, 1000, BlobFileMetaData::LinkedSsts{}, 1, 100);
+  AddBlob(third_blob, 10, 1000, BlobFileMetaData::LinkedSsts{second_sst}, 9,
+          900);
+  AddBlob(fourth_blob, 10, 1000, BlobFileMetaData::LinkedSsts{}, 9, 900);
+
+  UpdateVersionStorageInfo();
+
+  assert(vstorage_.num_levels() > 0);
+  const auto& level_files = vstorage_.LevelFiles(level);
+
+  assert(level_files.size() == 2);
+  assert(level_files[0] && level_files[0]->fd.GetNumber() == first_sst);
+  assert(level_files[1] && level_files[1]->fd.GetNumber() == second_sst);
+
+  // The second batch is only partially eligible for GC, and the oldest one
+  // alone does not meet the threshold
+
+  {
+    constexpr double age_cutoff = 0.75;
+    constexpr double force_threshold = 0.5;
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
+
+    ASSERT_TRUE(vstorage_.FilesMarkedForForcedBlobGC().empty());
+  }
+
+  // Only the oldest batch is eligible and meets the threshold
+
+  {
+    constexpr double age_cutoff = 0.75;
+    constexpr double force_threshold = 0.05;
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
+
+    auto ssts_to_be_compacted = vstorage_.FilesMarkedForForcedBlobGC();
+    ASSERT_EQ(ssts_to_be_compacted.size(), 1);
+    ASSERT_EQ(ssts_to_be_compacted[0],
+              (std::pair<int, FileMetaData*>(level, level_files[0])));
+  }
+
+  // Both batches are eligible, but their overall garbage ratio is below
+  // threshold
+
+  {
+    constexpr double age_cutoff = 1.0;
+    constexpr double force_threshold = 0.6;
+    constexpr uint32_t max_batches = 0;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
+
+    ASSERT_TRUE(vstorage_.FilesMarkedForForcedBlobGC().empty());
+  }
+
+  // Both batches are eligible and their overall garbage ratio meets threshold,
+  // but only the oldest batch may be considered, which does not
+
+  {
+    constexpr double age_cutoff = 1.0;
+    constexpr double force_threshold = 0.5;
+    constexpr uint32_t max_batches = 1;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
+
+    ASSERT_TRUE(vstorage_.FilesMarkedForForcedBlobGC().empty());
+  }
+
+  // Both batches are eligible and their overall garbage ratio meets threshold,
+  // even though the ratio of the oldest batch alone does not
+
+  {
+    constexpr double age_cutoff = 1.0;
+    constexpr double force_threshold = 0.5;
+    constexpr uint32_t max_batches = 2;
+    vstorage_.ComputeFilesMarkedForForcedBlobGC(age_cutoff, force_threshold,
+                                                max_batches);
 
     auto ssts_to_be_compacted = vstorage_.FilesMarkedForForcedBlobGC();
     ASSERT_EQ(ssts_to_be_compacted.size(), 2);
@@ -191,6 +191,20 @@ struct CompressionOptions {
   // Default: true
   bool use_zstd_dict_trainer;
 
+  // Reuse the dictionary of the first output file of a compaction for the
+  // following output files of the same compaction and output level, instead
+  // of buffering data and building a new dictionary for every file. The
+  // dictionary is still stored in every file, so the files are readable by
+  // older releases. This saves the dictionary building time and the memory
+  // of the buffered data blocks in every file but the first, at the cost of a
+  // dictionary that may fit the data of the later files less well.
+  //
+  // Flushes build a single file and are not affected. Has no effect when
+  // dictionary compression is disabled (`max_dict_bytes == 0`).
+  //
+  // Default: false
+  bool reuse_dict_across_files;
+
   CompressionOptions()
       : window_bits(-14),
         level(kDefaultCompressionLevel),
@@ -200,7 +214,8 @@ struct CompressionOptions {
         parallel_threads(1),
         enabled(false),
         max_dict_buffer_bytes(0),
-        use_zstd_dict_trainer(true) {}
+        use_zstd_dict_trainer(true),
+        reuse_dict_across_files(false) {}
   CompressionOptions(int wbits, int _lev, int _strategy,
                      uint32_t _max_dict_bytes, uint32_t _zstd_max_train_bytes,
                      uint32_t _parallel_threads, bool _enabled,
@@ -214,7 +229,8 @@ struct CompressionOptions {
         parallel_threads(_parallel_threads),
         enabled(_enabled),
         max_dict_buffer_bytes(_max_dict_buffer_bytes),
-        use_zstd_dict_trainer(_use_zstd_dict_trainer) {}
+        use_zstd_dict_trainer(_use_zstd_dict_trainer),
+        reuse_dict_across_files(false) {}
 };
 
 // Temperature of a file. Used to pass to FileSystem for a different
@@ -1018,8 +1034,9 @@ struct AdvancedColumnFamilyOptions {
   // If the ratio of garbage in the oldest blob files exceeds this threshold,
   // targeted compactions are scheduled in order to force garbage collecting
   // the blob files in question, assuming they are all eligible based on the
-  // value of blob_garbage_collection_age_cutoff above. This option is
-  // currently only supported with leveled compactions.
+  // value of blob_garbage_collection_age_cutoff above. See also
+  // blob_garbage_collection_force_max_batches below. This option is currently
+  // only supported with leveled compactions.
   // Note that enable_blob_garbage_collection has to be set in order for this
   // option to have any effect.
   //
@@ -1028,6 +1045,21 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   double blob_garbage_collection_force_threshold = 1.0;
 
+  // The maximum number of batches of the oldest blob files that forced blob
+  // GC considers. A batch is a blob file together with the newer blob files
+  // that are only kept alive by the SSTs referencing it. Forced GC picks the
+  // longest run of the oldest batches, up to this many, whose combined ratio
+  // of garbage meets blob_garbage_collection_force_threshold. A newer batch
+  // is thus only collected if the ratio over it and all the batches older
+  // than it meets the threshold, so a batch with a lot of garbage can still
+  // be held back by older batches of mostly valid blobs. 0 means no limit
+  // other than blob_garbage_collection_age_cutoff.
+  //
+  // Default: 1 (only the oldest batch)
+  //
+  // Dynamically changeable through the SetOptions() API
+  uint32_t blob_garbage_collection_force_max_batches = 1;
+
   // Compaction readahead for blob files.
   //
   // Default: 0
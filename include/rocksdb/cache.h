@@ -148,6 +148,21 @@ struct ShardedCacheOptions {
   // A SecondaryCache instance to use the non-volatile tier.
   std::shared_ptr<SecondaryCache> secondary_cache;
 
+  // EXPERIMENTAL
+  // If true, capacity is moved between this cache and secondary_cache while
+  // the cache is in use, keeping the sum of their capacities. Capacity goes
+  // to the secondary cache (more blocks per byte when it is compressed) while
+  // the estimated cost of the lookups missing both caches exceeds the time
+  // spent in secondary cache hits, and back to this cache otherwise. Each
+  // cache keeps at least a tenth of the sum. Ignored if secondary_cache is not
+  // set or does not support GetCapacity() and SetCapacity().
+  bool adaptive_secondary_cache_capacity = false;
+
+  // Estimated cost of a lookup that misses both this cache and
+  // secondary_cache, typically a block read from storage. Only used by
+  // adaptive_secondary_cache_capacity.
+  uint64_t secondary_cache_miss_cost_nanos = 50000;
+
   ShardedCacheOptions() {}
   ShardedCacheOptions(
       size_t _capacity, int _num_shard_bits, bool _strict_capacity_limit,
@@ -954,6 +954,24 @@ class DB {
     //      level, as well as the histogram of latency of single requests.
     static const std::string kCFFileHistogram;
 
+    //  "rocksdb.cf-latency-stats" - returns a multi-line string or map with
+    //      the latency histograms of the operations on the column family and
+    //      the bytes read from each level by point lookups. Only available
+    //      when DBOptions::enable_cf_latency_stats is set. The map has the
+    //      keys "<op>.count", "<op>.average", "<op>.p50", "<op>.p95",
+    //      "<op>.p99" and "<op>.max" for op in get, multiget, seek, next and
+    //      write (micros), and "level<N>.bytes-read" for each level.
+    static const std::string kCFLatencyStats;
+
+    //  "rocksdb.perf-context-samples" - returns a multi-line string or map
+    //      with percentiles of the time the sampled Get, MultiGet and Seek
+    //      operations on the column family spent in each step, overall and
+    //      by level. Only available when DBOptions::perf_context_sample_rate
+    //      is set. The map has the keys "<op>.<metric>.<stat>" and
+    //      "<op>.level<N>.<metric>.<stat>" for stat in count, p50, p95, p99
+    //      and max.
+    static const std::string kPerfContextSamples;
+
     // "rocksdb.cf-write-stall-stats" - returns a multi-line string or
     //      map with statistics on CF-scope write stalls for a given CF
     // See`WriteStallStatsMapKeys` for structured representation of keys
@@ -1895,6 +1913,16 @@ class DB {
     return Status::NotSupported("GetStatsHistory() is not implemented.");
   }
 
+  // Like GetStatsHistory() above, but the snapshots only contain the stats
+  // named in stat_names (all the stats if stat_names is empty). With
+  // persist_stats_to_disk, only these stats are decoded from disk.
+  virtual Status GetStatsHistory(
+      uint64_t /*start_time*/, uint64_t /*end_time*/,
+      const std::vector<std::string>& /*stat_names*/,
+      std::unique_ptr<StatsHistoryIterator>* /*stats_iterator*/) {
+    return Status::NotSupported("GetStatsHistory() is not implemented.");
+  }
+
   // Make the secondary instance catch up with the primary by tailing and
   // replaying the MANIFEST and WAL of the primary.
   // Column families created by the primary after the secondary instance starts
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <chrono>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -205,6 +206,33 @@ struct WriteStallInfo {
   } condition;
 };
 
+enum class SlowOperationType {
+  kGet,
+  kMultiGet,
+  kSeek,
+  kWrite,
+};
+
+// An operation that took at least DBOptions::slow_operation_threshold_micros
+struct SlowOperationInfo {
+  SlowOperationType type = SlowOperationType::kGet;
+  // The column family of the operation. Empty for writes, which may span
+  // several column families, and for MultiGet() calls on several column
+  // families.
+  std::string cf_name;
+  uint64_t duration_micros = 0;
+  // The numbers of the SST files the operation looked up or opened
+  // iterators on, in ascending order
+  std::vector<uint64_t> sst_files;
+  // The PerfContext and IOStatsContext counters the operation increased, by
+  // name (e.g. "block_read_count", "db_mutex_lock_nanos", "write_delay_time"
+  // or "iostats.bytes_read"). Counters are only increased when the perf level
+  // of the thread enables them: the timers need
+  // PerfLevel::kEnableTimeExceptForMutex, and the mutex wait timers
+  // PerfLevel::kEnableTime.
+  std::map<std::string, uint64_t> perf_counters;
+};
+
 
 struct FileDeletionInfo {
   FileDeletionInfo() = default;
@@ -834,6 +862,11 @@ class EventListener : public Customizable {
   // happens. ShouldBeNotifiedOnFileIO should be set to true to get a callback.
   virtual void OnIOError(const IOErrorInfo& /*info*/) {}
 
+  // A callback function for RocksDB which will be called on the thread of a
+  // Get, MultiGet, iterator Seek or write that took at least
+  // DBOptions::slow_operation_threshold_micros, after the operation.
+  virtual void OnSlowOperation(const SlowOperationInfo& /*info*/) {}
+
   ~EventListener() override {}
 };
 
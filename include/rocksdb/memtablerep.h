@@ -523,4 +523,14 @@ extern MemTableRepFactory* NewHashLinkListRepFactory(
 // The factory is to create memtables based on a sorted hash table - spdb hash:
 extern MemTableRepFactory* NewHashSpdbRepFactory(size_t bucket_count = 1000000);
 
+// The factory is to create memtables made of several skip lists, each holding
+// the user keys that hash to it. Concurrent inserts of different keys mostly
+// land in different skip lists and contend less, at the cost of merging the
+// skip lists when iterating or flushing. In memtablerep_bench with one writer,
+// inserts and point reads run about as fast as with the skip list, while a
+// full scan of 8 shards takes several times longer, so it suits write heavy
+// memtables that are rarely iterated.
+// @num_shards: number of skip lists in each memtable.
+extern MemTableRepFactory* NewShardedSkipListRepFactory(size_t num_shards = 8);
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -898,10 +898,47 @@ struct DBOptions {
   // which have previously set persist_stats_to_disk to true, the column family
   // creation will fail, but the hidden column family will survive, as well as
   // the previously persisted statistics.
-  // When peristing stats to disk, the stat name will be limited at 100 bytes.
+  // The persisted snapshots are stored in blocks of consecutive snapshots,
+  // each stat delta-of-delta encoded, and also include the p50, p95, p99 and
+  // max of the histograms that recorded values (named "<histogram>.p50"
+  // etc.). The snapshots persisted in the older one key per stat format are
+  // still read.
   // Default: false
   bool persist_stats_to_disk = false;
 
+  // If true, each column family keeps latency histograms of the Get,
+  // MultiGet, iterator Seek and Next operations and of the single key writes
+  // (Put, Delete, Merge etc.) made on it, and counts the bytes read from each
+  // level by its point lookups. The data is kept per core, and is reported
+  // by the "rocksdb.cf-latency-stats" property and in the column family
+  // stats dump. When false, the operations are not timed.
+  // Default: false
+  bool enable_cf_latency_stats = false;
+
+  // If not zero, 1 in perf_context_sample_rate Get, MultiGet and iterator
+  // Seek operations of each thread run with the PerfContext timers and per
+  // level PerfContext enabled, and each column family keeps histograms of the
+  // time the sampled operations spent in each step (block reads, checksums,
+  // decompression, filter and index reads, block seeks, I/O and the time
+  // spent in each level). They are reported by the
+  // "rocksdb.perf-context-samples" property. The timings of a sampled
+  // operation are also added to the PerfContext of its thread.
+  // Default: 0 (no sampling)
+  uint32_t perf_context_sample_rate = 0;
+
+  // If not zero, a Get, MultiGet, iterator Seek or write that takes at least
+  // this many microseconds is reported to the listeners through
+  // EventListener::OnSlowOperation() and logged to the info log, with the SST
+  // files it read and the PerfContext and IOStatsContext counters it
+  // increased (block reads and cache hits, mutex and write thread waits,
+  // write stall time etc.). The counters are only snapshotted at the start of
+  // each operation and compared once it is found slow, so fast operations
+  // only pay for reading the clock twice. The counters are filled according
+  // to the perf level of the thread; operations sampled through
+  // perf_context_sample_rate are always timed.
+  // Default: 0 (disabled)
+  uint64_t slow_operation_threshold_micros = 0;
+
   // if not zero, periodically take stats snapshots and store in memory, the
   // memory size for stats snapshots is capped at stats_history_buffer_size
   // Default: 1MB
@@ -1291,6 +1328,26 @@ struct DBOptions {
   // versions regardless of the wal_compression settings.
   CompressionType wal_compression = kNoCompression;
 
+  // If greater than zero and wal_compression is enabled, WAL records of at
+  // least 2MB (typically large write batches of bulk loaders) are split into
+  // 1MB segments that are compressed concurrently by a dedicated pool with
+  // this many threads, instead of only by the thread writing the WAL. Each
+  // segment is compressed independently, so the compression ratio of such
+  // records may be slightly lower. The WAL format is unchanged.
+  //
+  // Default: 0 (compress on the writing thread)
+  // Immutable.
+  int wal_compression_threads = 0;
+
+  // If true, DB::Open() reads each WAL on a separate thread while it replays
+  // the records already read into the memtables, so that reading, checksum
+  // verification and decompression of WAL records overlap with memtable
+  // inserts. Records are still applied in WAL order.
+  //
+  // Default: false
+  // Immutable.
+  bool enable_pipelined_wal_recovery = false;
+
   // If true, RocksDB supports flushing multiple column families and committing
   // their results atomically to MANIFEST. Note that it is not
   // necessary to set atomic_flush to true if WAL is always enabled since WAL
@@ -1593,6 +1650,14 @@ struct ReadOptions {
   // Default: 0
   size_t readahead_size;
 
+  // If non-zero, iterators read blob files ahead by this many bytes when they
+  // fetch blob values during forward iteration. Blob values are written in key
+  // order, so a range scan over blob-backed values can then be served by a
+  // few large sequential reads per blob file instead of one random read per
+  // value. Blobs found in the blob cache are not read from the file.
+  // Default: 0
+  size_t blob_readahead_size = 0;
+
   // A threshold for the number of keys that can be skipped before failing an
   // iterator seek as incomplete. The default value of 0 should be used to
   // never fail a request as incomplete, even on skipping too many keys.
@@ -2109,6 +2174,12 @@ struct IngestExternalFileOptions {
   //
   // ingest_behind takes precedence over fail_if_not_bottommost_level.
   bool fail_if_not_bottommost_level = false;
+  // Number of threads used to read the properties and key ranges of the
+  // ingested files, verify their block checksums and generate their file
+  // checksums. This work happens before writes are stopped, so a value above
+  // 1 mostly helps when ingesting many files at once. The threads are created
+  // for the duration of the call.
+  int num_prepare_threads = 1;
 };
 
 enum TraceFilterType : uint64_t {
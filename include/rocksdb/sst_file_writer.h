@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rocksdb/env.h"
 #include "rocksdb/options.h"
@@ -168,5 +169,57 @@ class SstFileWriter {
   struct Rep;
   std::unique_ptr<Rep> rep_;
 };
+
+// ParallelSstFileWriter turns one sorted stream of keys into a sequence of
+// sst files that are built concurrently by a pool of background threads.
+// The input is cut at key boundaries every `target_file_size` bytes of raw
+// key/value data, and each piece is written by its own SstFileWriter, so
+// compression and filter construction for different files proceed in
+// parallel with each other and with the caller. The resulting files do not
+// overlap and can be passed together to DB::IngestExternalFile().
+//
+// Output files are named `file_path_prefix` followed by a six digit sequence
+// number and ".sst", e.g. "/bulk/part-000001.sst".
+//
+// Input that has been cut but not yet written is buffered in memory; at most
+// 2 * `num_threads` pieces are queued before Put() blocks. With one piece
+// being written by each thread and one being filled by the caller, peak
+// memory is about (3 * `num_threads` + 1) * `target_file_size` of key/value
+// data. The buffers of written pieces are reused for later ones.
+class ParallelSstFileWriter {
+ public:
+  ParallelSstFileWriter(const EnvOptions& env_options, const Options& options,
+                        const std::string& file_path_prefix,
+                        uint64_t target_file_size, int num_threads,
+                        ColumnFamilyHandle* column_family = nullptr);
+
+  // Files that were already written are left in place if Finish() was not
+  // called.
+  ~ParallelSstFileWriter();
+
+  // Add a Put key with value.
+  // REQUIRES: key is after any previously added key according to comparator.
+  // REQUIRES: comparator is *not* timestamp-aware.
+  Status Put(const Slice& user_key, const Slice& value);
+
+  // Add a Merge key with value.
+  // REQUIRES: key is after any previously added key according to comparator.
+  // REQUIRES: comparator is *not* timestamp-aware.
+  Status Merge(const Slice& user_key, const Slice& value);
+
+  // Add a deletion key.
+  // REQUIRES: key is after any previously added key according to comparator.
+  // REQUIRES: comparator is *not* timestamp-aware.
+  Status Delete(const Slice& user_key);
+
+  // Write out any buffered input, wait for all background work and close
+  // every file. On success `file_info`, if not nullptr, is filled with one
+  // entry per created file in key order.
+  Status Finish(std::vector<ExternalSstFileInfo>* file_info = nullptr);
+
+ private:
+  struct Rep;
+  std::unique_ptr<Rep> rep_;
+};
 }  // namespace ROCKSDB_NAMESPACE
 
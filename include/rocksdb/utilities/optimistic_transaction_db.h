@@ -48,6 +48,18 @@ struct OptimisticTransactionDBOptions {
 
   // works only if validate_policy == OccValidationPolicy::kValidateParallel
   uint32_t occ_lock_buckets = (1 << 20);
+
+  // If non-zero, the DB keeps a table of this many slots with the latest
+  // sequence number written to the keys hashed to each slot (16 bytes per
+  // slot). Committing a transaction only looks up in the memtables the keys
+  // whose slot was written after the key was read, instead of every key
+  // tracked by the transaction.
+  //
+  // All writes must then go through the OptimisticTransactionDB, its
+  // transactions or its Write(), Put(), Delete(), SingleDelete(), Merge() and
+  // PutEntity() methods. Writes to the base DB are not seen by the table, and
+  // conflicts with them can be missed.
+  size_t key_version_cache_slots = 0;
 };
 
 // Range deletions (including those in `WriteBatch`es passed to `Write()`) are
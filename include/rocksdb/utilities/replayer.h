@@ -7,8 +7,10 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 
 #include "rocksdb/rocksdb_namespace.h"
+#include "rocksdb/slice.h"
 #include "rocksdb/status.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -28,10 +30,28 @@ struct ReplayOptions {
   //   If > 1, speed up the replay by this amount.
   double fast_forward;
 
-  ReplayOptions() : num_threads(1), fast_forward(1.0) {}
-
-  ReplayOptions(uint32_t num_of_threads, double fast_forward_ratio)
-      : num_threads(num_of_threads), fast_forward(fast_forward_ratio) {}
+  // Only used with num_threads > 1. If true, each thread has its own queue,
+  // the traces are queued by a hash of their key, and each thread executes
+  // its traces in order, so the operations on a key are replayed in the
+  // order of the trace while the traces on different keys run in parallel.
+  // Write batch and MultiGet traces are queued by their first key, and are
+  // only ordered with the other traces on that key. If false, the traces are
+  // executed by a pool of threads in any order.
+  bool preserve_key_order;
+
+  // If set, replaces every key of the traces (including the iterator
+  // bounds and the keys of the write batches) with the key it returns
+  // before executing them, e.g. to replay a trace on a different key space.
+  std::function<std::string(const Slice&)> key_remapper;
+
+  ReplayOptions()
+      : num_threads(1), fast_forward(1.0), preserve_key_order(false) {}
+
+  ReplayOptions(uint32_t num_of_threads, double fast_forward_ratio,
+                bool preserve_key_order_in_threads = false)
+      : num_threads(num_of_threads),
+        fast_forward(fast_forward_ratio),
+        preserve_key_order(preserve_key_order_in_threads) {}
 };
 
 // Replayer helps to replay the captured RocksDB query level operations.
@@ -397,6 +397,29 @@ class Transaction {
     return Status::NotSupported();
   }
 
+  // Lock all of `keys` as GetForUpdate() with a nullptr value would, but
+  // with one call into the lock manager for all keys that this transaction
+  // has not locked yet. Later writes to these keys in this transaction do not
+  // need to lock them again. The keys are locked in an order that is the
+  // same for every transaction, so two LockKeys() calls do not deadlock each
+  // other over the keys that neither transaction held before the call. Locks
+  // already held by a transaction, whether taken by GetForUpdate(), Put() or
+  // an earlier LockKeys(), can still form a deadlock cycle with the keys it
+  // waits for here. TransactionOptions::deadlock_detect and lock_timeout
+  // still apply to every key this call waits for.
+  //
+  // If a lock cannot be acquired, none of the keys that were not locked
+  // before are locked on return. A failed snapshot validation may leave the
+  // keys that were validated before it locked, as a series of GetForUpdate()
+  // calls would.
+  //
+  // Only supported by transactions created by a TransactionDB.
+  virtual Status LockKeys(ColumnFamilyHandle* /*column_family*/,
+                          const std::vector<Slice>& /*keys*/,
+                          bool /*exclusive*/ = true) {
+    return Status::NotSupported();
+  }
+
   virtual Status GetForUpdate(const ReadOptions& options, const Slice& key,
                               std::string* value, bool exclusive = true,
                               const bool do_validate = true) = 0;
@@ -301,6 +301,12 @@ struct TransactionOptions {
   // The maximum number of bytes used for the write batch. 0 means no limit.
   size_t max_write_batch_size = 0;
 
+  // If true, the keys written by the transaction are sorted into its write
+  // batch index only when the transaction first reads from it (Get,
+  // GetForUpdate, iterators, ...), which makes write-only transactions
+  // cheaper. See WriteBatchWithIndex::SetLazyIndexing().
+  bool lazy_write_batch_index = false;
+
   // Skip Concurrency Control. This could be as an optimization if the
   // application knows that the transaction would not have any conflict with
   // concurrent transactions. It could also be used during recovery if (i)
@@ -280,6 +280,16 @@ class WriteBatchWithIndex : public WriteBatchBase {
   void SetMaxBytes(size_t max_bytes) override;
   size_t GetDataSize() const;
 
+  // If enabled, updates are appended to an unsorted list instead of being
+  // inserted into the index. The list is sorted and merged into the index on
+  // the first read from the batch (an iterator, GetFromBatch*() or
+  // MultiGetFromBatchAndDB()), after which updates go to the index directly
+  // again until Clear(). This makes updates cheaper for batches that are
+  // mostly written and rarely or never read before being written to the DB.
+  // Disabled by default. Disabling it sorts the pending updates into the
+  // index right away.
+  void SetLazyIndexing(bool lazy_indexing);
+
  private:
   friend class PessimisticTransactionDB;
   friend class WritePreparedTxn;
@@ -64,6 +64,7 @@ DEFINE_string(memtablerep, "skiplist",
               "\thashskiplist        -- backed by a hash skip list\n"
               "\thashlinklist        -- backed by a hash linked list\n"
               "\thashspdb            -- backed by a hash spdb\n"
+              "\tsharded_skip_list   -- backed by several skiplists\n"
               "\tcuckoo              -- backed by a cuckoo hash table");
 
 DEFINE_int64(bucket_count, 1000000,
@@ -94,6 +95,9 @@ DEFINE_int32(
     threshold_use_skiplist, 256,
     "threshold_use_skiplist parameter to pass into NewHashLinkListRepFactory");
 
+DEFINE_int64(num_shards, 8,
+             "num_shards parameter to pass into NewShardedSkipListRepFactory");
+
 DEFINE_int64(write_buffer_size, 256,
              "write_buffer_size parameter to pass into WriteBufferManager");
 
@@ -112,6 +116,11 @@ DEFINE_int32(num_scans, 10,
 
 DEFINE_int32(item_size, 100, "Number of bytes each item should be");
 
+DEFINE_int32(key_prefix_size, 0,
+             "Number of bytes of a prefix shared by all keys, written ahead "
+             "of the 8 byte key number. Use it to measure the memory spent on "
+             "long common key prefixes.");
+
 DEFINE_int32(prefix_length, 8,
              "Prefix length to pass into NewFixedPrefixTransform");
 
@@ -160,6 +169,19 @@ class RandomGenerator {
 
 enum WriteMode { SEQUENTIAL, RANDOM, UNIQUE_RANDOM };
 
+// Size of the internal keys written by the benchmarks: a prefix of
+// FLAGS_key_prefix_size bytes, the key number and the sequence number.
+size_t InternalKeySize() { return FLAGS_key_prefix_size + 8 + 8; }
+
+// Writes the user key for `key` to `dst`, which must have room for
+// InternalKeySize() - 8 bytes, and returns a pointer past it.
+char* EncodeUserKey(uint64_t key, char* dst) {
+  memset(dst, 'k', FLAGS_key_prefix_size);
+  dst += FLAGS_key_prefix_size;
+  EncodeFixed64(dst, key);
+  return dst + 8;
+}
+
 class KeyGenerator {
  public:
   KeyGenerator(Random64* rand, WriteMode mode, uint64_t num)
@@ -237,15 +259,14 @@ class FillBenchmarkThread : public BenchmarkThread {
 
   void FillOne() {
     char* buf = nullptr;
-    auto internal_key_size = 16;
+    auto internal_key_size = static_cast<uint32_t>(InternalKeySize());
     auto encoded_len =
         FLAGS_item_size + VarintLength(internal_key_size) + internal_key_size;
     KeyHandle handle = table_->Allocate(encoded_len, &buf);
     assert(buf != nullptr);
     char* p = EncodeVarint32(buf, internal_key_size);
     auto key = key_gen_->Next();
-    EncodeFixed64(p, key);
-    p += 8;
+    p = EncodeUserKey(key, p);
     EncodeFixed64(p, ++(*sequence_));
     p += 8;
     Slice bytes = generator_.Generate(FLAGS_item_size);
@@ -310,9 +331,9 @@ class ReadBenchmarkThread : public BenchmarkThread {
   }
 
   void ReadOne() {
-    std::string user_key;
+    std::string user_key(InternalKeySize() - 8, '\0');
     auto key = key_gen_->Next();
-    PutFixed64(&user_key, key);
+    EncodeUserKey(key, &user_key[0]);
     LookupKey lookup_key(user_key, *sequence_);
     InternalKeyComparator internal_key_comp(BytewiseComparator());
     CallbackVerifyArgs verify_args;
@@ -322,7 +343,8 @@ class ReadBenchmarkThread : public BenchmarkThread {
     verify_args.comparator = &internal_key_comp;
     table_->Get(lookup_key, &verify_args, callback);
     if (verify_args.found) {
-      *bytes_read_ += VarintLength(16) + 16 + FLAGS_item_size;
+      *bytes_read_ += VarintLength(InternalKeySize()) + InternalKeySize() +
+                       FLAGS_item_size;
       ++*read_hits_;
     }
   }
@@ -346,7 +368,8 @@ class SeqReadBenchmarkThread : public BenchmarkThread {
     std::unique_ptr<MemTableRep::Iterator> iter(table_->GetIterator());
     for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
       // pretend to read the value
-      *bytes_read_ += VarintLength(16) + 16 + FLAGS_item_size;
+      *bytes_read_ += VarintLength(InternalKeySize()) + InternalKeySize() +
+                       FLAGS_item_size;
     }
     ++*read_hits_;
   }
@@ -573,6 +596,12 @@ int main(int argc, char** argv) {
                   " [OPTIONS]...");
   ParseCommandLineFlags(&argc, &argv, true);
 
+  if (FLAGS_key_prefix_size < 0) {
+    fprintf(stderr, "--key_prefix_size must be >= 0, got %d\n",
+            FLAGS_key_prefix_size);
+    exit(1);
+  }
+
   PrintWarnings();
 
   ROCKSDB_NAMESPACE::Options options;
@@ -598,6 +627,9 @@ int main(int argc, char** argv) {
         ROCKSDB_NAMESPACE::NewFixedPrefixTransform(FLAGS_prefix_length));
   } else if (FLAGS_memtablerep == "hashspdb") {
     factory.reset(ROCKSDB_NAMESPACE::NewHashSpdbRepFactory(FLAGS_bucket_count));
+  } else if (FLAGS_memtablerep == "sharded_skip_list") {
+    factory.reset(
+        ROCKSDB_NAMESPACE::NewShardedSkipListRepFactory(FLAGS_num_shards));
   } else {
     ROCKSDB_NAMESPACE::ConfigOptions config_options;
     config_options.ignore_unsupported_options = false;
@@ -682,7 +714,15 @@ int main(int argc, char** argv) {
       continue;
     }
     std::cout << "Running " << name.ToString() << std::endl;
+    const size_t memory_before = arena.MemoryAllocatedBytes();
     benchmark->Run();
+    const size_t memory_used = arena.MemoryAllocatedBytes() - memory_before;
+    if (memory_used > 0) {
+      std::cout << "Memtable memory allocated: "
+                << static_cast<double>(memory_used) / (1 << 20) << " MiB ("
+                << static_cast<double>(memory_used) / FLAGS_num_operations
+                << " bytes/op)" << std::endl;
+    }
   }
 
   return 0;
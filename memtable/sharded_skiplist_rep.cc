@@ -0,0 +1,382 @@
+// Copyright (C) 2023 Speedb Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A memtable rep made of several independent skip lists. Every user key is
+// assigned to one of the skip lists by its hash, so concurrent writers mostly
+// link their nodes into different skip lists instead of racing on the towers
+// of a single one. All the versions of a user key live in the same skip list,
+// which keeps point lookups and duplicate detection on a single skip list.
+// Iterators merge the skip lists through a small heap, which makes scans and
+// flushes somewhat slower than with a single skip list.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "db/memtable.h"
+#include "memory/arena.h"
+#include "memtable/inlineskiplist.h"
+#include "rocksdb/memtablerep.h"
+#include "rocksdb/utilities/options_type.h"
+#include "util/heap.h"
+#include "util/murmurhash.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+class ShardedSkipListRep : public MemTableRep {
+  using SkipList = InlineSkipList<const MemTableRep::KeyComparator&>;
+
+ public:
+  ShardedSkipListRep(const MemTableRep::KeyComparator& compare,
+                     Allocator* allocator, size_t num_shards)
+      : MemTableRep(allocator), cmp_(compare) {
+    assert(num_shards > 0);
+    auto key_comparator = static_cast<const MemTable::KeyComparator*>(&cmp_);
+    ts_sz_ = key_comparator->comparator.user_comparator()->timestamp_size();
+    shards_.reserve(num_shards);
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(new SkipList(compare, allocator));
+    }
+  }
+
+  KeyHandle Allocate(const size_t len, char** buf) override {
+    // All the skip lists share the allocator and the node layout, so a node
+    // allocated through any of them can be linked into the shard of its key.
+    *buf = shards_[0]->AllocateKey(len);
+    return static_cast<KeyHandle>(*buf);
+  }
+
+  void Insert(KeyHandle handle) override {
+    const char* key = static_cast<char*>(handle);
+    GetShard(key)->Insert(key);
+  }
+
+  bool InsertKey(KeyHandle handle) override {
+    const char* key = static_cast<char*>(handle);
+    return GetShard(key)->Insert(key);
+  }
+
+  // A hint caches a position in a single skip list, while consecutive keys
+  // sharing a hint may belong to different shards, so hints are ignored.
+  bool InsertKeyWithHint(KeyHandle handle, void** /*hint*/) override {
+    return InsertKey(handle);
+  }
+
+  void InsertWithHintConcurrently(KeyHandle handle, void** /*hint*/) override {
+    InsertConcurrently(handle);
+  }
+
+  bool InsertKeyWithHintConcurrently(KeyHandle handle,
+                                     void** /*hint*/) override {
+    return InsertKeyConcurrently(handle);
+  }
+
+  void InsertConcurrently(KeyHandle handle) override {
+    const char* key = static_cast<char*>(handle);
+    GetShard(key)->InsertConcurrently(key);
+  }
+
+  bool InsertKeyConcurrently(KeyHandle handle) override {
+    const char* key = static_cast<char*>(handle);
+    return GetShard(key)->InsertConcurrently(key);
+  }
+
+  bool Contains(const char* key) const override {
+    return GetShard(key)->Contains(key);
+  }
+
+  size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override {
+    // The entries of the looked up user key are all in the same shard, and
+    // the callback stops at the first entry of another user key.
+    const char* memtable_key = k.memtable_key().data();
+    SkipList::Iterator iter(GetShard(memtable_key));
+    for (iter.Seek(memtable_key);
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+  }
+
+  uint64_t ApproximateNumEntries(const Slice& start_ikey,
+                                 const Slice& end_ikey) override {
+    std::string tmp;
+    uint64_t count = 0;
+    for (const auto& shard : shards_) {
+      uint64_t start_count = shard->EstimateCount(EncodeKey(&tmp, start_ikey));
+      uint64_t end_count = shard->EstimateCount(EncodeKey(&tmp, end_ikey));
+      count += (end_count >= start_count) ? (end_count - start_count) : 0;
+    }
+    return count;
+  }
+
+  void UniqueRandomSample(const uint64_t num_entries,
+                          const uint64_t target_sample_size,
+                          std::unordered_set<const char*>* entries) override {
+    entries->clear();
+    assert(target_sample_size > 0);
+    assert(num_entries > 0);
+    Random* rnd = Random::GetTLSInstance();
+    // Same two methods as SkipListRep::UniqueRandomSample(). Keys are spread
+    // evenly over the shards, so a random entry of a random shard is close
+    // enough to a random entry of the memtable.
+    if (target_sample_size >
+        static_cast<uint64_t>(std::sqrt(1.0 * num_entries))) {
+      Iterator iter(this);
+      iter.SeekToFirst();
+      uint64_t counter = 0, num_samples_left = target_sample_size;
+      for (; iter.Valid() && (num_samples_left > 0); iter.Next(), counter++) {
+        if (rnd->Next() % (num_entries - counter) < num_samples_left) {
+          entries->insert(iter.key());
+          num_samples_left--;
+        }
+      }
+    } else {
+      for (uint64_t i = 0; i < target_sample_size; i++) {
+        for (uint64_t j = 0; j < 5; j++) {
+          SkipList::Iterator iter(shards_[rnd->Uniform(
+                                              static_cast<int>(shards_.size()))]
+                                      .get());
+          iter.RandomSeek();
+          if (!iter.Valid() || entries->insert(iter.key()).second) {
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  ~ShardedSkipListRep() override {}
+
+  // Merges the iterators of all the shards.
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    explicit Iterator(const ShardedSkipListRep* rep)
+        : cmp_(rep->cmp_), heap_(ChildComparator(this)) {
+      children_.reserve(rep->shards_.size());
+      for (const auto& shard : rep->shards_) {
+        children_.emplace_back(shard.get());
+      }
+    }
+
+    ~Iterator() override {}
+
+    bool Valid() const override { return !heap_.empty(); }
+
+    const char* key() const override {
+      assert(Valid());
+      return children_[heap_.top()].key();
+    }
+
+    void Next() override {
+      assert(Valid());
+      if (!forward_) {
+        SwitchDirection(true /* forward */);
+        return;
+      }
+      const size_t current = heap_.top();
+      children_[current].Next();
+      if (children_[current].Valid()) {
+        heap_.replace_top(current);
+      } else {
+        heap_.pop();
+      }
+    }
+
+    void Prev() override {
+      assert(Valid());
+      if (forward_) {
+        SwitchDirection(false /* forward */);
+        return;
+      }
+      const size_t current = heap_.top();
+      children_[current].Prev();
+      if (children_[current].Valid()) {
+        heap_.replace_top(current);
+      } else {
+        heap_.pop();
+      }
+    }
+
+    void Seek(const Slice& user_key, const char* memtable_key) override {
+      const char* target =
+          memtable_key != nullptr ? memtable_key : EncodeKey(&tmp_, user_key);
+      forward_ = true;
+      heap_.clear();
+      for (size_t i = 0; i < children_.size(); ++i) {
+        children_[i].Seek(target);
+        AddToHeap(i);
+      }
+    }
+
+    void SeekForPrev(const Slice& user_key, const char* memtable_key) override {
+      const char* target =
+          memtable_key != nullptr ? memtable_key : EncodeKey(&tmp_, user_key);
+      forward_ = false;
+      heap_.clear();
+      for (size_t i = 0; i < children_.size(); ++i) {
+        children_[i].SeekForPrev(target);
+        AddToHeap(i);
+      }
+    }
+
+    void SeekToFirst() override {
+      forward_ = true;
+      heap_.clear();
+      for (size_t i = 0; i < children_.size(); ++i) {
+        children_[i].SeekToFirst();
+        AddToHeap(i);
+      }
+    }
+
+    void SeekToLast() override {
+      forward_ = false;
+      heap_.clear();
+      for (size_t i = 0; i < children_.size(); ++i) {
+        children_[i].SeekToLast();
+        AddToHeap(i);
+      }
+    }
+
+   private:
+    // Orders the children by their current key, smallest on top when moving
+    // forward and largest on top when moving backward.
+    class ChildComparator {
+     public:
+      explicit ChildComparator(const Iterator* iter) : iter_(iter) {}
+      bool operator()(size_t a, size_t b) const {
+        const int c =
+            iter_->cmp_(iter_->children_[a].key(), iter_->children_[b].key());
+        return iter_->forward_ ? c > 0 : c < 0;
+      }
+
+     private:
+      const Iterator* iter_;
+    };
+
+    void AddToHeap(size_t i) {
+      if (children_[i].Valid()) {
+        heap_.push(i);
+      }
+    }
+
+    // Moves to the entry after (or before) the current one when changing the
+    // direction of the iteration. Entries are unique across the shards, so
+    // every other child is positioned strictly after (or before) the current
+    // key.
+    void SwitchDirection(bool forward) {
+      const size_t current = heap_.top();
+      const char* target = children_[current].key();
+      forward_ = forward;
+      heap_.clear();
+      for (size_t i = 0; i < children_.size(); ++i) {
+        if (i == current) {
+          continue;
+        }
+        if (forward) {
+          children_[i].Seek(target);
+        } else {
+          children_[i].SeekForPrev(target);
+        }
+        AddToHeap(i);
+      }
+      if (forward) {
+        children_[current].Next();
+      } else {
+        children_[current].Prev();
+      }
+      AddToHeap(current);
+    }
+
+    const MemTableRep::KeyComparator& cmp_;
+    std::vector<SkipList::Iterator> children_;
+    BinaryHeap<size_t, ChildComparator> heap_;
+    bool forward_ = true;
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override {
+    void* mem = arena ? arena->AllocateAligned(sizeof(Iterator))
+                      : operator new(sizeof(Iterator));
+    return new (mem) Iterator(this);
+  }
+
+ private:
+  SkipList* GetShard(const char* key) const {
+    Slice user_key =
+        ExtractUserKeyAndStripTimestamp(cmp_.decode_key(key), ts_sz_);
+    const size_t hash =
+        MurmurHash(user_key.data(), static_cast<int>(user_key.size()), 0);
+    return shards_[hash % shards_.size()].get();
+  }
+
+  const MemTableRep::KeyComparator& cmp_;
+  size_t ts_sz_;
+  std::vector<std::unique_ptr<SkipList>> shards_;
+};
+
+struct ShardedSkipListRepOptions {
+  static const char* kName() { return "ShardedSkipListRepOptions"; }
+  size_t num_shards;
+};
+
+static std::unordered_map<std::string, OptionTypeInfo>
+    sharded_skiplist_factory_info = {
+        {"num_shards",
+         {offsetof(struct ShardedSkipListRepOptions, num_shards),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
+class ShardedSkipListRepFactory : public MemTableRepFactory {
+ public:
+  explicit ShardedSkipListRepFactory(size_t num_shards) {
+    options_.num_shards = num_shards;
+    RegisterOptions(&options_, &sharded_skiplist_factory_info);
+  }
+
+  using MemTableRepFactory::CreateMemTableRep;
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator& compare,
+                                 Allocator* allocator,
+                                 const SliceTransform* /*transform*/,
+                                 Logger* /*logger*/) override {
+    return new ShardedSkipListRep(compare, allocator,
+                                  std::max<size_t>(options_.num_shards, 1));
+  }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+  bool CanHandleDuplicatedKey() const override { return true; }
+
+  static const char* kClassName() { return "ShardedSkipListRepFactory"; }
+  static const char* kNickName() { return "sharded_skip_list"; }
+  const char* Name() const override { return kClassName(); }
+  const char* NickName() const override { return kNickName(); }
+
+ private:
+  ShardedSkipListRepOptions options_;
+};
+
+}  // namespace
+
+MemTableRepFactory* NewShardedSkipListRepFactory(size_t num_shards) {
+  return new ShardedSkipListRepFactory(num_shards);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
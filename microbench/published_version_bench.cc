@@ -0,0 +1,91 @@
+// Copyright (C) 2023 Speedb Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares reading an immutable list published through PublishedVersion with
+// loading it through std::atomic_load() of a std::shared_ptr, which takes one
+// of a small pool of mutexes in the common standard libraries and updates the
+// shared reference count, as the number of reading threads grows.
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "rocksdb/types.h"
+#include "util/published_version.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// The length of the list, like the snapshots of a WritePreparedTxnDB that do
+// not fit into its snapshot cache
+constexpr size_t kListSize = 256;
+
+std::vector<SequenceNumber> MakeList() {
+  std::vector<SequenceNumber> list(kListSize);
+  for (size_t i = 0; i < kListSize; i++) {
+    list[i] = i * 2;
+  }
+  return list;
+}
+
+std::shared_ptr<const std::vector<SequenceNumber>> shared_list;
+PublishedVersion<std::vector<SequenceNumber>>* published_list;
+}  // namespace
+
+static void AtomicSharedPtrRead(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_list =
+        std::make_shared<const std::vector<SequenceNumber>>(MakeList());
+  }
+  SequenceNumber seq = 0;
+  size_t found = 0;
+  for (auto _ : state) {
+    auto list = std::atomic_load_explicit(&shared_list,
+                                          std::memory_order_acquire);
+    found += std::binary_search(list->begin(), list->end(), seq++ % kListSize);
+  }
+  benchmark::DoNotOptimize(found);
+  if (state.thread_index() == 0) {
+    shared_list.reset();
+  }
+}
+
+BENCHMARK(AtomicSharedPtrRead)->ThreadRange(1, 16)->UseRealTime();
+
+static void PublishedVersionRead(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    published_list = new PublishedVersion<std::vector<SequenceNumber>>();
+    published_list->Publish(MakeList());
+  }
+  SequenceNumber seq = 0;
+  size_t found = 0;
+  for (auto _ : state) {
+    PublishedVersion<std::vector<SequenceNumber>>::ReadGuard list(
+        published_list);
+    found += std::binary_search(list->begin(), list->end(), seq++ % kListSize);
+  }
+  benchmark::DoNotOptimize(found);
+  if (state.thread_index() == 0) {
+    delete published_list;
+    published_list = nullptr;
+  }
+}
+
+BENCHMARK(PublishedVersionRead)->ThreadRange(1, 16)->UseRealTime();
+
+}  // namespace ROCKSDB_NAMESPACE
+
+BENCHMARK_MAIN();
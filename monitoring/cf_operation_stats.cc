@@ -0,0 +1,123 @@
+// Copyright (C) 2023 Speedb Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "monitoring/cf_operation_stats.h"
+
+#include <cassert>
+#include <sstream>
+
+namespace ROCKSDB_NAMESPACE {
+
+CFOperationStats::CFOperationStats(int num_levels) : num_levels_(num_levels) {
+  for (size_t core_idx = 0; core_idx < per_core_stats_.Size(); ++core_idx) {
+    auto& bytes_read = per_core_stats_.AccessAtCore(core_idx)->bytes_read;
+    bytes_read.reset(new std::atomic<uint64_t>[num_levels_]);
+    for (int level = 0; level < num_levels_; ++level) {
+      bytes_read[level].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+const char* CFOperationStats::OperationName(OperationType type) {
+  switch (type) {
+    case kGet:
+      return "get";
+    case kMultiGet:
+      return "multiget";
+    case kSeek:
+      return "seek";
+    case kNext:
+      return "next";
+    case kWrite:
+      return "write";
+    default:
+      assert(false);
+      return "unknown";
+  }
+}
+
+void CFOperationStats::GetLatency(OperationType type,
+                                  HistogramImpl* hist) const {
+  assert(type < kNumOperationTypes);
+  for (size_t core_idx = 0; core_idx < per_core_stats_.Size(); ++core_idx) {
+    hist->Merge(per_core_stats_.AccessAtCore(core_idx)->latency[type]);
+  }
+}
+
+uint64_t CFOperationStats::GetBytesRead(int level) const {
+  assert(level >= 0 && level < num_levels_);
+  uint64_t bytes_read = 0;
+  for (size_t core_idx = 0; core_idx < per_core_stats_.Size(); ++core_idx) {
+    const auto* core_stats = per_core_stats_.AccessAtCore(core_idx);
+    bytes_read += core_stats->bytes_read[level].load(std::memory_order_relaxed);
+  }
+  return bytes_read;
+}
+
+void CFOperationStats::Clear() {
+  for (size_t core_idx = 0; core_idx < per_core_stats_.Size(); ++core_idx) {
+    auto* core_stats = per_core_stats_.AccessAtCore(core_idx);
+    for (auto& hist : core_stats->latency) {
+      hist.Clear();
+    }
+    for (int level = 0; level < num_levels_; ++level) {
+      core_stats->bytes_read[level].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+std::string CFOperationStats::ToString(const std::string& cf_name) const {
+  std::ostringstream oss;
+  oss << "\n** Operation Latency Histograms [" << cf_name << "] **\n";
+  for (uint32_t type = 0; type < kNumOperationTypes; ++type) {
+    HistogramImpl hist;
+    GetLatency(static_cast<OperationType>(type), &hist);
+    if (!hist.Empty()) {
+      oss << "** " << OperationName(static_cast<OperationType>(type))
+          << " latency histogram (micros):\n"
+          << hist.ToString() << '\n';
+    }
+  }
+  oss << "** Point lookup bytes read by level:\n";
+  for (int level = 0; level < num_levels_; ++level) {
+    uint64_t bytes_read = GetBytesRead(level);
+    if (bytes_read > 0) {
+      oss << "Level " << level << ": " << bytes_read << '\n';
+    }
+  }
+  return oss.str();
+}
+
+void CFOperationStats::ToMap(std::map<std::string, std::string>* values) const {
+  for (uint32_t type = 0; type < kNumOperationTypes; ++type) {
+    HistogramImpl hist;
+    GetLatency(static_cast<OperationType>(type), &hist);
+    HistogramData data;
+    hist.Data(&data);
+    const std::string prefix =
+        std::string(OperationName(static_cast<OperationType>(type))) + ".";
+    (*values)[prefix + "count"] = std::to_string(data.count);
+    (*values)[prefix + "average"] = std::to_string(data.average);
+    (*values)[prefix + "p50"] = std::to_string(data.median);
+    (*values)[prefix + "p95"] = std::to_string(data.percentile95);
+    (*values)[prefix + "p99"] = std::to_string(data.percentile99);
+    (*values)[prefix + "max"] = std::to_string(data.max);
+  }
+  for (int level = 0; level < num_levels_; ++level) {
+    (*values)["level" + std::to_string(level) + ".bytes-read"] =
+        std::to_string(GetBytesRead(level));
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
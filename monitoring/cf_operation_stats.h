@@ -0,0 +1,116 @@
+// Copyright (C) 2023 Speedb Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "monitoring/histogram.h"
+#include "port/port.h"
+#include "rocksdb/system_clock.h"
+#include "util/core_local.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Latency histograms of the user operations on a single column family, and
+// the bytes read from each level by its point lookups. Like StatisticsImpl,
+// the data is kept per core so that recording does not contend between
+// threads, and merged when read.
+//
+// Only created when DBOptions::enable_cf_latency_stats is set.
+class CFOperationStats {
+ public:
+  enum OperationType : uint32_t {
+    kGet = 0,
+    kMultiGet,
+    kSeek,
+    kNext,
+    kWrite,
+    kNumOperationTypes
+  };
+
+  explicit CFOperationStats(int num_levels);
+
+  void RecordLatency(OperationType type, uint64_t micros) {
+    per_core_stats_.Access()->latency[type].Add(micros);
+  }
+
+  void AddBytesRead(int level, uint64_t bytes) {
+    if (bytes > 0 && level >= 0 && level < num_levels_) {
+      per_core_stats_.Access()->bytes_read[level].fetch_add(
+          bytes, std::memory_order_relaxed);
+    }
+  }
+
+  // Merges the latency histograms of the operation from all the cores into
+  // hist.
+  void GetLatency(OperationType type, HistogramImpl* hist) const;
+
+  uint64_t GetBytesRead(int level) const;
+
+  void Clear();
+
+  std::string ToString(const std::string& cf_name) const;
+
+  void ToMap(std::map<std::string, std::string>* values) const;
+
+  static const char* OperationName(OperationType type);
+
+ private:
+  struct ALIGN_AS(CACHE_LINE_SIZE) PerCoreStats {
+    HistogramImpl latency[kNumOperationTypes];
+    std::unique_ptr<std::atomic<uint64_t>[]> bytes_read;
+
+    void* operator new(size_t s) { return port::cacheline_aligned_alloc(s); }
+    void* operator new[](size_t s) { return port::cacheline_aligned_alloc(s); }
+    void operator delete(void* p) { port::cacheline_aligned_free(p); }
+    void operator delete[](void* p) { port::cacheline_aligned_free(p); }
+  };
+
+  const int num_levels_;
+  CoreLocalArray<PerCoreStats> per_core_stats_;
+};
+
+// Records the time from construction to destruction as the latency of an
+// operation, unless stats is nullptr.
+class CFOperationTimer {
+ public:
+  CFOperationTimer(SystemClock* clock, CFOperationStats* stats,
+                   CFOperationStats::OperationType type)
+      : clock_(clock),
+        stats_(stats),
+        type_(type),
+        start_time_(stats != nullptr ? clock->NowMicros() : 0) {}
+
+  CFOperationTimer(const CFOperationTimer&) = delete;
+  CFOperationTimer& operator=(const CFOperationTimer&) = delete;
+
+  ~CFOperationTimer() {
+    if (stats_ != nullptr) {
+      stats_->RecordLatency(type_, clock_->NowMicros() - start_time_);
+    }
+  }
+
+ private:
+  SystemClock* clock_;
+  CFOperationStats* stats_;
+  const CFOperationStats::OperationType type_;
+  const uint64_t start_time_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
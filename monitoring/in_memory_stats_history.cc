@@ -42,6 +42,15 @@ void InMemoryStatsHistoryIterator::AdvanceIteratorByTime(uint64_t start_time,
   if (db_impl_ != nullptr) {
     valid_ =
         db_impl_->FindStatsByTime(start_time, end_time, &time_, &stats_map_);
+    if (valid_ && !stat_names_.empty()) {
+      for (auto it = stats_map_.begin(); it != stats_map_.end();) {
+        if (stat_names_.count(it->first) == 0) {
+          it = stats_map_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
   } else {
     valid_ = false;
   }
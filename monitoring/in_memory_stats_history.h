@@ -8,6 +8,10 @@
 
 #pragma once
 
+#include <set>
+#include <string>
+#include <vector>
+
 #include "rocksdb/stats_history.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -25,11 +29,14 @@ namespace ROCKSDB_NAMESPACE {
 class InMemoryStatsHistoryIterator final : public StatsHistoryIterator {
  public:
   // Setup InMemoryStatsHistoryIterator to return stats snapshots between
-  // seconds timestamps [start_time, end_time)
+  // seconds timestamps [start_time, end_time), only keeping the stats named
+  // in stat_names if it is not empty
   InMemoryStatsHistoryIterator(uint64_t start_time, uint64_t end_time,
-                               DBImpl* db_impl)
+                               DBImpl* db_impl,
+                               const std::vector<std::string>& stat_names = {})
       : start_time_(start_time),
         end_time_(end_time),
+        stat_names_(stat_names.begin(), stat_names.end()),
         valid_(true),
         db_impl_(db_impl) {
     AdvanceIteratorByTime(start_time_, end_time_);
@@ -65,6 +72,7 @@ class InMemoryStatsHistoryIterator final : public StatsHistoryIterator {
   uint64_t time_;
   uint64_t start_time_;
   uint64_t end_time_;
+  const std::set<std::string> stat_names_;
   std::map<std::string, uint64_t> stats_map_;
   Status status_;
   bool valid_;
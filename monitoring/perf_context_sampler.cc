@@ -0,0 +1,304 @@
+// Copyright (C) 2023 Speedb Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "monitoring/perf_context_sampler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <cstdio>
+
+#include "rocksdb/iostats_context.h"
+#include "rocksdb/perf_context.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Operations of the thread since the last sampled one
+thread_local uint32_t tl_ops_since_sample = 0;
+// A sampled operation is running on the thread
+thread_local bool tl_sampling = false;
+
+void AppendHistogram(const std::string& name, const HistogramImpl& hist,
+                     std::string* value) {
+  HistogramData data;
+  hist.Data(&data);
+  char buf[256];
+  snprintf(buf, sizeof(buf),
+           "%s P50 : %f P95 : %f P99 : %f P100 : %f COUNT : %" PRIu64
+           " SUM : %" PRIu64 "\n",
+           name.c_str(), data.median, data.percentile95, data.percentile99,
+           data.max, data.count, data.sum);
+  value->append(buf);
+}
+
+void AddHistogramToMap(const std::string& name, const HistogramImpl& hist,
+                       std::map<std::string, std::string>* values) {
+  HistogramData data;
+  hist.Data(&data);
+  (*values)[name + ".count"] = std::to_string(data.count);
+  (*values)[name + ".p50"] = std::to_string(data.median);
+  (*values)[name + ".p95"] = std::to_string(data.percentile95);
+  (*values)[name + ".p99"] = std::to_string(data.percentile99);
+  (*values)[name + ".max"] = std::to_string(data.max);
+}
+
+// The contexts may have been reset by the operation
+uint64_t Delta(uint64_t start, uint64_t end) {
+  return end >= start ? end - start : end;
+}
+}  // namespace
+
+PerfContextSampler::PerfContextSampler(uint32_t sample_rate)
+    : sample_rate_(std::max<uint32_t>(sample_rate, 1)) {}
+
+bool PerfContextSampler::ShouldSample() const {
+  if (tl_sampling || ++tl_ops_since_sample < sample_rate_) {
+    return false;
+  }
+  tl_ops_since_sample = 0;
+  return true;
+}
+
+const char* PerfContextSampler::OperationName(OperationType type) {
+  switch (type) {
+    case kGet:
+      return "get";
+    case kMultiGet:
+      return "multiget";
+    case kSeek:
+      return "seek";
+    default:
+      assert(false);
+      return "unknown";
+  }
+}
+
+const char* PerfContextSampler::MetricName(Metric metric) {
+  switch (metric) {
+    case kTotalNanos:
+      return "total_nanos";
+    case kMemtableNanos:
+      return "memtable_nanos";
+    case kFindTableNanos:
+      return "find_table_nanos";
+    case kReadIndexBlockNanos:
+      return "read_index_block_nanos";
+    case kReadFilterBlockNanos:
+      return "read_filter_block_nanos";
+    case kBlockReadNanos:
+      return "block_read_nanos";
+    case kBlockChecksumNanos:
+      return "block_checksum_nanos";
+    case kBlockDecompressNanos:
+      return "block_decompress_nanos";
+    case kBlockSeekNanos:
+      return "block_seek_nanos";
+    case kFileReadNanos:
+      return "file_read_nanos";
+    case kBlockCacheHitCount:
+      return "block_cache_hit_count";
+    case kBlockReadCount:
+      return "block_read_count";
+    default:
+      assert(false);
+      return "unknown";
+  }
+}
+
+const char* PerfContextSampler::LevelMetricName(LevelMetric metric) {
+  switch (metric) {
+    case kGetFromTableNanos:
+      return "get_from_table_nanos";
+    case kBlockCacheMissCount:
+      return "block_cache_miss_count";
+    default:
+      assert(false);
+      return "unknown";
+  }
+}
+
+void PerfContextSampler::GetHistogram(OperationType type, Metric metric,
+                                      HistogramImpl* hist) const {
+  assert(type < kNumOperationTypes && metric < kNumMetrics);
+  hist->Merge(hists_[type][metric]);
+}
+
+void PerfContextSampler::GetLevelHistogram(OperationType type, int level,
+                                           LevelMetric metric,
+                                           HistogramImpl* hist) const {
+  assert(type < kNumOperationTypes && metric < kNumLevelMetrics);
+  assert(level >= 0 && level < kNumSampledLevels);
+  hist->Merge(level_hists_[type][level][metric]);
+}
+
+void PerfContextSampler::Clear() {
+  for (auto& type_hists : hists_) {
+    for (auto& hist : type_hists) {
+      hist.Clear();
+    }
+  }
+  for (auto& type_hists : level_hists_) {
+    for (auto& level_hists : type_hists) {
+      for (auto& hist : level_hists) {
+        hist.Clear();
+      }
+    }
+  }
+}
+
+std::string PerfContextSampler::ToString(const std::string& cf_name) const {
+  std::string value = "\n** Sampled PerfContext Breakdown [" + cf_name +
+                      "] (1 in " + std::to_string(sample_rate_) +
+                      " operations) **\n";
+  for (uint32_t type = 0; type < kNumOperationTypes; ++type) {
+    const std::string op = OperationName(static_cast<OperationType>(type));
+    if (hists_[type][kTotalNanos].Empty()) {
+      continue;
+    }
+    for (uint32_t metric = 0; metric < kNumMetrics; ++metric) {
+      AppendHistogram(op + "." + MetricName(static_cast<Metric>(metric)),
+                      hists_[type][metric], &value);
+    }
+    for (int level = 0; level < kNumSampledLevels; ++level) {
+      if (level_hists_[type][level][kGetFromTableNanos].Empty()) {
+        continue;
+      }
+      for (uint32_t metric = 0; metric < kNumLevelMetrics; ++metric) {
+        AppendHistogram(
+            op + ".level" + std::to_string(level) + "." +
+                LevelMetricName(static_cast<LevelMetric>(metric)),
+            level_hists_[type][level][metric], &value);
+      }
+    }
+  }
+  return value;
+}
+
+void PerfContextSampler::ToMap(
+    std::map<std::string, std::string>* values) const {
+  for (uint32_t type = 0; type < kNumOperationTypes; ++type) {
+    const std::string op = OperationName(static_cast<OperationType>(type));
+    for (uint32_t metric = 0; metric < kNumMetrics; ++metric) {
+      AddHistogramToMap(op + "." + MetricName(static_cast<Metric>(metric)),
+                        hists_[type][metric], values);
+    }
+    for (int level = 0; level < kNumSampledLevels; ++level) {
+      for (uint32_t metric = 0; metric < kNumLevelMetrics; ++metric) {
+        AddHistogramToMap(
+            op + ".level" + std::to_string(level) + "." +
+                LevelMetricName(static_cast<LevelMetric>(metric)),
+            level_hists_[type][level][metric], values);
+      }
+    }
+  }
+}
+
+void PerfContextSampleGuard::Snapshot(
+    SystemClock* clock, uint64_t* values,
+    uint64_t (*level_values)[PerfContextSampler::kNumLevelMetrics]) {
+  const PerfContext* perf = get_perf_context();
+  const IOStatsContext* iostats = get_iostats_context();
+  values[PerfContextSampler::kTotalNanos] = clock->NowNanos();
+  values[PerfContextSampler::kMemtableNanos] =
+      perf->get_from_memtable_time + perf->seek_on_memtable_time;
+  values[PerfContextSampler::kFindTableNanos] = perf->find_table_nanos;
+  values[PerfContextSampler::kReadIndexBlockNanos] =
+      perf->read_index_block_nanos;
+  values[PerfContextSampler::kReadFilterBlockNanos] =
+      perf->read_filter_block_nanos;
+  values[PerfContextSampler::kBlockReadNanos] = perf->block_read_time;
+  values[PerfContextSampler::kBlockChecksumNanos] = perf->block_checksum_time;
+  values[PerfContextSampler::kBlockDecompressNanos] =
+      perf->block_decompress_time;
+  values[PerfContextSampler::kBlockSeekNanos] = perf->block_seek_nanos;
+  values[PerfContextSampler::kFileReadNanos] = iostats->read_nanos;
+  values[PerfContextSampler::kBlockCacheHitCount] =
+      perf->block_cache_hit_count;
+  values[PerfContextSampler::kBlockReadCount] = perf->block_read_count;
+
+  for (int level = 0; level < PerfContextSampler::kNumSampledLevels;
+       ++level) {
+    uint64_t* level_value = level_values[level];
+    level_value[PerfContextSampler::kGetFromTableNanos] = 0;
+    level_value[PerfContextSampler::kBlockCacheMissCount] = 0;
+    if (perf->level_to_perf_context == nullptr) {
+      continue;
+    }
+    auto iter = perf->level_to_perf_context->find(level);
+    if (iter != perf->level_to_perf_context->end()) {
+      level_value[PerfContextSampler::kGetFromTableNanos] =
+          iter->second.get_from_table_nanos;
+      level_value[PerfContextSampler::kBlockCacheMissCount] =
+          iter->second.block_cache_miss_count;
+    }
+  }
+}
+
+void PerfContextSampleGuard::Start(SystemClock* clock,
+                                   PerfContextSampler* sampler,
+                                   PerfContextSampler::OperationType type) {
+  sampler_ = sampler;
+  clock_ = clock;
+  type_ = type;
+  tl_sampling = true;
+  saved_perf_level_ = GetPerfLevel();
+  if (saved_perf_level_ < PerfLevel::kEnableTimeExceptForMutex) {
+    SetPerfLevel(PerfLevel::kEnableTimeExceptForMutex);
+  }
+  PerfContext* perf = get_perf_context();
+  saved_per_level_enabled_ = perf->per_level_perf_context_enabled;
+  if (!saved_per_level_enabled_) {
+    perf->EnablePerLevelPerfContext();
+  }
+  Snapshot(clock_, start_values_, start_level_values_);
+}
+
+void PerfContextSampleGuard::Finish() {
+  uint64_t end_values[PerfContextSampler::kNumMetrics];
+  uint64_t end_level_values[PerfContextSampler::kNumSampledLevels]
+                           [PerfContextSampler::kNumLevelMetrics];
+  Snapshot(clock_, end_values, end_level_values);
+
+  PerfContext* perf = get_perf_context();
+  if (!saved_per_level_enabled_) {
+    perf->DisablePerLevelPerfContext();
+  }
+  if (saved_perf_level_ < PerfLevel::kEnableTimeExceptForMutex) {
+    SetPerfLevel(saved_perf_level_);
+  }
+  tl_sampling = false;
+
+  for (uint32_t metric = 0; metric < PerfContextSampler::kNumMetrics;
+       ++metric) {
+    sampler_->hists_[type_][metric].Add(
+        Delta(start_values_[metric], end_values[metric]));
+  }
+  for (int level = 0; level < PerfContextSampler::kNumSampledLevels; ++level) {
+    const uint64_t* end_level_value = end_level_values[level];
+    const uint64_t* start_level_value = start_level_values_[level];
+    if (end_level_value[PerfContextSampler::kGetFromTableNanos] ==
+        start_level_value[PerfContextSampler::kGetFromTableNanos]) {
+      // The level was not read
+      continue;
+    }
+    for (uint32_t metric = 0; metric < PerfContextSampler::kNumLevelMetrics;
+         ++metric) {
+      sampler_->level_hists_[type_][level][metric].Add(
+          Delta(start_level_value[metric], end_level_value[metric]));
+    }
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,148 @@
+// Copyright (C) 2023 Speedb Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "monitoring/histogram.h"
+#include "rocksdb/perf_level.h"
+#include "rocksdb/system_clock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Breakdowns of where the time of the read operations on a column family
+// goes, from a sample of the operations.
+//
+// 1 in sample_rate operations of each thread runs with the PerfContext
+// timers enabled (PerfLevel::kEnableTimeExceptForMutex) and per level
+// PerfContext enabled, and adds what the operation spent on each step to a
+// histogram of the step. The other operations only count down a thread local
+// counter. Since only the sampled operations record, the histograms are
+// shared rather than per core.
+//
+// Only created when DBOptions::perf_context_sample_rate is not 0.
+class PerfContextSampler {
+ public:
+  enum OperationType : uint32_t {
+    kGet = 0,
+    kMultiGet,
+    kSeek,
+    kNumOperationTypes
+  };
+
+  enum Metric : uint32_t {
+    // Time of the whole operation
+    kTotalNanos = 0,
+    kMemtableNanos,
+    kFindTableNanos,
+    kReadIndexBlockNanos,
+    kReadFilterBlockNanos,
+    kBlockReadNanos,
+    kBlockChecksumNanos,
+    kBlockDecompressNanos,
+    kBlockSeekNanos,
+    kFileReadNanos,
+    kBlockCacheHitCount,
+    kBlockReadCount,
+    kNumMetrics
+  };
+
+  // The first levels broken down by level
+  static constexpr int kNumSampledLevels = 8;
+
+  enum LevelMetric : uint32_t {
+    kGetFromTableNanos = 0,
+    kBlockCacheMissCount,
+    kNumLevelMetrics
+  };
+
+  explicit PerfContextSampler(uint32_t sample_rate);
+
+  // Counts an operation of the calling thread, and returns true if it is to
+  // be sampled. Never samples an operation started by a sampled operation.
+  bool ShouldSample() const;
+
+  void GetHistogram(OperationType type, Metric metric,
+                    HistogramImpl* hist) const;
+
+  void GetLevelHistogram(OperationType type, int level, LevelMetric metric,
+                         HistogramImpl* hist) const;
+
+  void Clear();
+
+  std::string ToString(const std::string& cf_name) const;
+
+  void ToMap(std::map<std::string, std::string>* values) const;
+
+  static const char* OperationName(OperationType type);
+  static const char* MetricName(Metric metric);
+  static const char* LevelMetricName(LevelMetric metric);
+
+ private:
+  friend class PerfContextSampleGuard;
+
+  const uint32_t sample_rate_;
+  HistogramImpl hists_[kNumOperationTypes][kNumMetrics];
+  HistogramImpl level_hists_[kNumOperationTypes][kNumSampledLevels]
+                            [kNumLevelMetrics];
+};
+
+// Samples the operation from construction to destruction if sampler is not
+// nullptr and the operation is picked for sampling. The perf level of the
+// thread is raised for the duration of a sampled operation, so the timings of
+// the operation are also added to the PerfContext and IOStatsContext of the
+// thread.
+class PerfContextSampleGuard {
+ public:
+  PerfContextSampleGuard(SystemClock* clock, PerfContextSampler* sampler,
+                         PerfContextSampler::OperationType type) {
+    if (sampler != nullptr && sampler->ShouldSample()) {
+      Start(clock, sampler, type);
+    }
+  }
+
+  PerfContextSampleGuard(const PerfContextSampleGuard&) = delete;
+  PerfContextSampleGuard& operator=(const PerfContextSampleGuard&) = delete;
+
+  ~PerfContextSampleGuard() {
+    if (sampler_ != nullptr) {
+      Finish();
+    }
+  }
+
+ private:
+  void Start(SystemClock* clock, PerfContextSampler* sampler,
+             PerfContextSampler::OperationType type);
+  void Finish();
+
+  // The current values of the counters behind the metrics
+  static void Snapshot(
+      SystemClock* clock, uint64_t* values,
+      uint64_t (*level_values)[PerfContextSampler::kNumLevelMetrics]);
+
+  PerfContextSampler* sampler_ = nullptr;
+  SystemClock* clock_ = nullptr;
+  PerfContextSampler::OperationType type_ = PerfContextSampler::kGet;
+  PerfLevel saved_perf_level_ = PerfLevel::kDisable;
+  bool saved_per_level_enabled_ = false;
+  // Only set for a sampled operation
+  uint64_t start_values_[PerfContextSampler::kNumMetrics];
+  uint64_t start_level_values_[PerfContextSampler::kNumSampledLevels]
+                              [PerfContextSampler::kNumLevelMetrics];
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -8,11 +8,13 @@
 
 #include "monitoring/persistent_stats_history.h"
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <utility>
 
 #include "db/db_impl/db_impl.h"
+#include "util/coding.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -27,8 +29,13 @@ const std::string kCompatibleVersionKeyString =
 // designates what type of encoding will be used when writing to stats CF;
 // compatible format version designates the minimum format version that
 // can decode the stats CF encoded using the current format version.
-const uint64_t kStatsCFCurrentFormatVersion = 1;
+// Format version 1 readers skip the stats blocks of format version 2, and
+// only see the snapshots persisted in format version 1.
+const uint64_t kStatsCFCurrentFormatVersion = 2;
 const uint64_t kStatsCFCompatibleFormatVersion = 1;
+const uint32_t kStatsSnapshotsPerBlock = 64;
+// The first character of the keys of the stats blocks
+const char kStatsBlockKeyPrefix = 'c';
 
 Status DecodePersistentStatsVersionNumber(DBImpl* db, StatsVersionKeyType type,
                                           uint64_t* version_number) {
@@ -65,6 +72,139 @@ int EncodePersistentStatsKey(uint64_t now_seconds, const std::string& key,
   return snprintf(buf, size, "%s#%s", timestamp, key.c_str());
 }
 
+std::string EncodeStatsBlockKey(uint64_t block_start_time) {
+  char key[kNowSecondsStringLength + 2];
+  snprintf(key, sizeof(key), "%c%010d", kStatsBlockKeyPrefix,
+           static_cast<int>(block_start_time));
+  return std::string(key, kNowSecondsStringLength + 1);
+}
+
+namespace {
+void EncodeStatsColumn(const std::vector<uint64_t>& values, std::string* dst) {
+  uint64_t prev_value = 0;
+  uint64_t prev_delta = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i == 0) {
+      PutVarint64(dst, values[i]);
+    } else {
+      const uint64_t delta = values[i] - prev_value;
+      PutVarsignedint64(dst, static_cast<int64_t>(delta - prev_delta));
+      prev_delta = delta;
+    }
+    prev_value = values[i];
+  }
+}
+
+bool DecodeStatsColumn(Slice* input, size_t count, uint64_t* values) {
+  uint64_t prev_value = 0;
+  uint64_t prev_delta = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (i == 0) {
+      if (!GetVarint64(input, &prev_value)) {
+        return false;
+      }
+    } else {
+      int64_t delta_of_delta = 0;
+      if (!GetVarsignedint64(input, &delta_of_delta)) {
+        return false;
+      }
+      prev_delta += static_cast<uint64_t>(delta_of_delta);
+      prev_value += prev_delta;
+    }
+    values[i] = prev_value;
+  }
+  return input->empty();
+}
+}  // namespace
+
+void PersistentStatsBlockBuilder::Add(
+    uint64_t time, const std::map<std::string, uint64_t>& stats,
+    std::string* key, std::string* value) {
+  if (times_.size() >= kStatsSnapshotsPerBlock) {
+    times_.clear();
+    columns_.clear();
+  }
+  const uint32_t snapshot = static_cast<uint32_t>(times_.size());
+  times_.push_back(time);
+  for (const auto& stat : stats) {
+    Column& column = columns_[stat.first];
+    if (column.values.empty()) {
+      column.first_snapshot = snapshot;
+    }
+    column.values.push_back(stat.second);
+  }
+  // A stat missing from the snapshot is persisted as 0
+  for (auto& column : columns_) {
+    if (column.second.first_snapshot + column.second.values.size() <
+        times_.size()) {
+      column.second.values.push_back(0);
+    }
+  }
+
+  *key = EncodeStatsBlockKey(times_.front());
+  value->clear();
+  PutVarint32(value, static_cast<uint32_t>(times_.size()));
+  std::string column_data;
+  EncodeStatsColumn(times_, &column_data);
+  PutLengthPrefixedSlice(value, column_data);
+  PutVarint32(value, static_cast<uint32_t>(columns_.size()));
+  for (const auto& column : columns_) {
+    PutLengthPrefixedSlice(value, column.first);
+    PutVarint32(value, column.second.first_snapshot);
+    column_data.clear();
+    EncodeStatsColumn(column.second.values, &column_data);
+    PutLengthPrefixedSlice(value, column_data);
+  }
+}
+
+Status DecodePersistentStatsBlock(
+    const Slice& block, const std::set<std::string>& stat_names,
+    std::vector<uint64_t>* times,
+    std::vector<std::map<std::string, uint64_t>>* snapshots) {
+  Slice input = block;
+  uint32_t num_snapshots = 0;
+  Slice column_data;
+  times->clear();
+  snapshots->clear();
+  if (!GetVarint32(&input, &num_snapshots) || num_snapshots == 0 ||
+      num_snapshots > kStatsSnapshotsPerBlock ||
+      !GetLengthPrefixedSlice(&input, &column_data)) {
+    return Status::Corruption("Invalid persistent stats block header");
+  }
+  times->resize(num_snapshots);
+  if (!DecodeStatsColumn(&column_data, num_snapshots, times->data())) {
+    return Status::Corruption("Invalid persistent stats block times");
+  }
+  snapshots->resize(num_snapshots);
+  uint32_t num_columns = 0;
+  if (!GetVarint32(&input, &num_columns)) {
+    return Status::Corruption("Invalid persistent stats block header");
+  }
+  uint64_t values[kStatsSnapshotsPerBlock];
+  for (uint32_t i = 0; i < num_columns; ++i) {
+    Slice name;
+    uint32_t first_snapshot = 0;
+    if (!GetLengthPrefixedSlice(&input, &name) ||
+        !GetVarint32(&input, &first_snapshot) ||
+        first_snapshot >= num_snapshots ||
+        !GetLengthPrefixedSlice(&input, &column_data)) {
+      return Status::Corruption("Invalid persistent stats block column");
+    }
+    const std::string name_str = name.ToString();
+    if (!stat_names.empty() && stat_names.count(name_str) == 0) {
+      continue;
+    }
+    const size_t count = num_snapshots - first_snapshot;
+    if (!DecodeStatsColumn(&column_data, count, values)) {
+      return Status::Corruption("Invalid persistent stats column " + name_str);
+    }
+    for (size_t j = 0; j < count; ++j) {
+      (*snapshots)[first_snapshot + j][name_str] = values[j];
+    }
+  }
+  return Status::OK();
+}
+
 void OptimizeForPersistentStats(ColumnFamilyOptions* cfo) {
   cfo->write_buffer_size = 2 << 20;
   cfo->target_file_size_base = 2 * 1048576;
@@ -120,50 +260,135 @@ std::pair<uint64_t, std::string> parseKey(const Slice& key,
 // if success, update time_ and stats_map_ with new_time and stats_map
 void PersistentStatsHistoryIterator::AdvanceIteratorByTime(uint64_t start_time,
                                                            uint64_t end_time) {
-  // try to find next entry in stats_history_ map
-  if (db_impl_ != nullptr) {
-    ReadOptions ro;
-    Iterator* iter =
-        db_impl_->NewIterator(ro, db_impl_->PersistentStatsColumnFamily());
-
-    char timestamp[kNowSecondsStringLength + 1];
-    snprintf(timestamp, sizeof(timestamp), "%010d",
-             static_cast<int>(std::max(time_, start_time)));
-    timestamp[kNowSecondsStringLength] = '\0';
-
-    iter->Seek(timestamp);
-    // no more entries with timestamp >= start_time is found or version key
-    // is found to be incompatible
-    if (!iter->Valid()) {
-      valid_ = false;
-      delete iter;
-      return;
-    }
-    time_ = parseKey(iter->key(), start_time).first;
+  if (db_impl_ == nullptr) {
+    valid_ = false;
+    return;
+  }
+  // The snapshots of the two formats are merged by time, as a DB may have
+  // been reopened by releases persisting either format
+  uint64_t legacy_time = 0;
+  std::map<std::string, uint64_t> legacy_stats_map;
+  const bool legacy_found = FindLegacyStats(start_time, end_time, &legacy_time,
+                                            &legacy_stats_map);
+  uint64_t block_time = 0;
+  std::map<std::string, uint64_t> block_stats_map;
+  const bool block_found =
+      status_.ok() &&
+      FindBlockStats(start_time, legacy_found ? legacy_time : end_time,
+                     &block_time, &block_stats_map);
+  if (!status_.ok()) {
+    valid_ = false;
+  } else if (block_found) {
     valid_ = true;
-    // check parsed time and invalid if it exceeds end_time
-    if (time_ > end_time) {
-      valid_ = false;
-      delete iter;
-      return;
-    }
-    // find all entries with timestamp equal to time_
-    std::map<std::string, uint64_t> new_stats_map;
-    std::pair<uint64_t, std::string> kv;
-    for (; iter->Valid(); iter->Next()) {
-      kv = parseKey(iter->key(), start_time);
-      if (kv.first != time_) {
-        break;
+    time_ = block_time;
+    stats_map_.swap(block_stats_map);
+  } else if (legacy_found) {
+    valid_ = true;
+    time_ = legacy_time;
+    stats_map_.swap(legacy_stats_map);
+  } else {
+    valid_ = false;
+  }
+}
+
+bool PersistentStatsHistoryIterator::FindLegacyStats(
+    uint64_t start_time, uint64_t end_time, uint64_t* time,
+    std::map<std::string, uint64_t>* stats_map) {
+  ReadOptions ro;
+  Iterator* iter =
+      db_impl_->NewIterator(ro, db_impl_->PersistentStatsColumnFamily());
+
+  char timestamp[kNowSecondsStringLength + 1];
+  snprintf(timestamp, sizeof(timestamp), "%010d",
+           static_cast<int>(std::max(time_, start_time)));
+  timestamp[kNowSecondsStringLength] = '\0';
+
+  iter->Seek(timestamp);
+  // no more entries with timestamp >= start_time is found or version key
+  // is found to be incompatible
+  if (!iter->Valid()) {
+    delete iter;
+    return false;
+  }
+  *time = parseKey(iter->key(), start_time).first;
+  // check parsed time and invalid if it exceeds end_time
+  if (*time > end_time) {
+    delete iter;
+    return false;
+  }
+  // find all entries with timestamp equal to time_
+  std::pair<uint64_t, std::string> kv;
+  for (; iter->Valid(); iter->Next()) {
+    kv = parseKey(iter->key(), start_time);
+    if (kv.first != *time) {
+      break;
+    }
+    if (kv.second.compare(kFormatVersionKeyString) == 0) {
+      continue;
+    }
+    if (!stat_names_.empty() && stat_names_.count(kv.second) == 0) {
+      continue;
+    }
+    (*stats_map)[kv.second] = ParseUint64(iter->value().ToString());
+  }
+  delete iter;
+  return true;
+}
+
+bool PersistentStatsHistoryIterator::FindBlockStats(
+    uint64_t start_time, uint64_t end_time, uint64_t* time,
+    std::map<std::string, uint64_t>* stats_map) {
+  while (true) {
+    if (block_loaded_) {
+      auto it = std::lower_bound(block_times_.begin(), block_times_.end(),
+                                 start_time);
+      if (it != block_times_.end()) {
+        if (*it > end_time) {
+          return false;
+        }
+        *time = *it;
+        stats_map->swap(block_snapshots_[it - block_times_.begin()]);
+        return true;
       }
-      if (kv.second.compare(kFormatVersionKeyString) == 0) {
-        continue;
+    }
+
+    // Read the block with the snapshots following the loaded block, or the
+    // block start_time falls in
+    ReadOptions ro;
+    std::unique_ptr<Iterator> iter(
+        db_impl_->NewIterator(ro, db_impl_->PersistentStatsColumnFamily()));
+    if (block_loaded_) {
+      iter->Seek(EncodeStatsBlockKey(block_start_time_ + 1));
+    } else {
+      iter->SeekForPrev(EncodeStatsBlockKey(start_time));
+      if (!iter->Valid() || iter->key().empty() ||
+          iter->key()[0] != kStatsBlockKeyPrefix) {
+        iter->Seek(EncodeStatsBlockKey(start_time));
       }
-      new_stats_map[kv.second] = ParseUint64(iter->value().ToString());
     }
-    stats_map_.swap(new_stats_map);
-    delete iter;
-  } else {
-    valid_ = false;
+    if (!iter->Valid() || iter->key().empty() ||
+        iter->key()[0] != kStatsBlockKeyPrefix) {
+      status_ = iter->status();
+      return false;
+    }
+    Slice key = iter->key();
+    key.remove_prefix(1);
+    const uint64_t block_start_time = ParseUint64(key.ToString());
+    if (block_loaded_ && block_start_time <= block_start_time_) {
+      // Guard against a corrupted key
+      status_ = Status::Corruption("Invalid persistent stats block key");
+      return false;
+    }
+    if (block_start_time > end_time) {
+      return false;
+    }
+    status_ = DecodePersistentStatsBlock(iter->value(), stat_names_,
+                                         &block_times_, &block_snapshots_);
+    if (!status_.ok()) {
+      return false;
+    }
+    block_loaded_ = true;
+    block_start_time_ = block_start_time;
   }
 }
 
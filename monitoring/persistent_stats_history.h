@@ -8,6 +8,11 @@
 
 #pragma once
 
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
 #include "db/db_impl/db_impl.h"
 #include "rocksdb/stats_history.h"
 
@@ -30,7 +35,7 @@ enum StatsVersionKeyType : uint32_t {
 Status DecodePersistentStatsVersionNumber(DBImpl* db, StatsVersionKeyType type,
                                           uint64_t* version_number);
 
-// Encode timestamp and stats key into buf
+// Encode timestamp and stats key of format version 1 into buf
 // Format: timestamp(10 digit) + '#' + key
 // Total length of encoded key will be capped at 100 bytes
 int EncodePersistentStatsKey(uint64_t timestamp, const std::string& key,
@@ -38,13 +43,63 @@ int EncodePersistentStatsKey(uint64_t timestamp, const std::string& key,
 
 void OptimizeForPersistentStats(ColumnFamilyOptions* cfo);
 
+// Format version 2 stores the stats snapshots in blocks of up to
+// kStatsSnapshotsPerBlock consecutive snapshots, one record per block, keyed
+// by the time of the first snapshot of the block (see EncodeStatsBlockKey()).
+// A block is columnar: the snapshot times, then each stat in turn, each
+// column holding its first value as is and the following ones as zigzag
+// varint delta-of-deltas. Stats that change by a steady amount (or not at all)
+// between snapshots take a byte per snapshot. Every column is prefixed with
+// its length, so reading some stats skips over the other columns without
+// decoding them.
+//
+// The record of the block being filled is rewritten on every snapshot, and
+// a reopened DB starts a new block.
+extern const uint32_t kStatsSnapshotsPerBlock;
+
+// Format: 'c' + timestamp(10 digit). Sorts after the version keys and the
+// format version 1 keys.
+std::string EncodeStatsBlockKey(uint64_t block_start_time);
+
+// Builds the stats blocks of format version 2
+class PersistentStatsBlockBuilder {
+ public:
+  // Adds the stats snapshot taken at time to the block being filled, or to a
+  // new block if it is full, and returns the key and value to write for the
+  // block.
+  void Add(uint64_t time, const std::map<std::string, uint64_t>& stats,
+           std::string* key, std::string* value);
+
+ private:
+  struct Column {
+    // The snapshot of the block the stat first appears in
+    uint32_t first_snapshot = 0;
+    std::vector<uint64_t> values;
+  };
+
+  std::vector<uint64_t> times_;
+  std::map<std::string, Column> columns_;
+};
+
+// Decodes the snapshots of a stats block, only keeping the stats whose name
+// is in stat_names if stat_names is not empty
+Status DecodePersistentStatsBlock(
+    const Slice& block, const std::set<std::string>& stat_names,
+    std::vector<uint64_t>* times,
+    std::vector<std::map<std::string, uint64_t>>* snapshots);
+
 class PersistentStatsHistoryIterator final : public StatsHistoryIterator {
  public:
-  PersistentStatsHistoryIterator(uint64_t start_time, uint64_t end_time,
-                                 DBImpl* db_impl)
+  // Iterates over the stats snapshots with times in [start_time, end_time],
+  // only returning the stats whose name is in stat_names if stat_names is not
+  // empty. Reads the snapshots of both format versions.
+  PersistentStatsHistoryIterator(
+      uint64_t start_time, uint64_t end_time, DBImpl* db_impl,
+      const std::vector<std::string>& stat_names = {})
       : time_(0),
         start_time_(start_time),
         end_time_(end_time),
+        stat_names_(stat_names.begin(), stat_names.end()),
         valid_(true),
         db_impl_(db_impl) {
     AdvanceIteratorByTime(start_time_, end_time_);
@@ -63,6 +118,13 @@ class PersistentStatsHistoryIterator final : public StatsHistoryIterator {
   // between [start_time, end_time)
   void AdvanceIteratorByTime(uint64_t start_time, uint64_t end_time);
 
+  // Find the first snapshot of format version 1, or in the stats blocks,
+  // with timestamp between [start_time, end_time]
+  bool FindLegacyStats(uint64_t start_time, uint64_t end_time, uint64_t* time,
+                       std::map<std::string, uint64_t>* stats_map);
+  bool FindBlockStats(uint64_t start_time, uint64_t end_time, uint64_t* time,
+                      std::map<std::string, uint64_t>* stats_map);
+
   // No copying allowed
   PersistentStatsHistoryIterator(const PersistentStatsHistoryIterator&) =
       delete;
@@ -74,10 +136,16 @@ class PersistentStatsHistoryIterator final : public StatsHistoryIterator {
   uint64_t time_;
   uint64_t start_time_;
   uint64_t end_time_;
+  const std::set<std::string> stat_names_;
   std::map<std::string, uint64_t> stats_map_;
   Status status_;
   bool valid_;
   DBImpl* db_impl_;
+  // The last stats block read
+  bool block_loaded_ = false;
+  uint64_t block_start_time_ = 0;
+  std::vector<uint64_t> block_times_;
+  std::vector<std::map<std::string, uint64_t>> block_snapshots_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,171 @@
+// Copyright (C) 2023 Speedb Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "monitoring/slow_operation_tracker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+
+#include "logging/logging.h"
+#include "options/db_options.h"
+#include "rocksdb/iostats_context.h"
+#include "rocksdb/perf_context.h"
+#include "rocksdb/system_clock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+thread_local SlowOperationTracker* SlowOperationTracker::current_ = nullptr;
+
+namespace {
+struct PerfCounter {
+  const char* name;
+  uint64_t PerfContext::*member;
+};
+
+const PerfCounter kPerfCounters[] = {
+    {"get_from_memtable_time", &PerfContext::get_from_memtable_time},
+    {"get_from_output_files_time", &PerfContext::get_from_output_files_time},
+    {"seek_internal_seek_time", &PerfContext::seek_internal_seek_time},
+    {"find_table_nanos", &PerfContext::find_table_nanos},
+    {"block_cache_hit_count", &PerfContext::block_cache_hit_count},
+    {"block_read_count", &PerfContext::block_read_count},
+    {"block_read_byte", &PerfContext::block_read_byte},
+    {"block_read_time", &PerfContext::block_read_time},
+    {"block_checksum_time", &PerfContext::block_checksum_time},
+    {"block_decompress_time", &PerfContext::block_decompress_time},
+    {"read_index_block_nanos", &PerfContext::read_index_block_nanos},
+    {"read_filter_block_nanos", &PerfContext::read_filter_block_nanos},
+    {"db_mutex_lock_nanos", &PerfContext::db_mutex_lock_nanos},
+    {"db_condition_wait_nanos", &PerfContext::db_condition_wait_nanos},
+    {"write_wal_time", &PerfContext::write_wal_time},
+    {"write_memtable_time", &PerfContext::write_memtable_time},
+    {"write_delay_time", &PerfContext::write_delay_time},
+    {"write_thread_wait_nanos", &PerfContext::write_thread_wait_nanos},
+    {"write_pre_and_post_process_time",
+     &PerfContext::write_pre_and_post_process_time},
+};
+
+constexpr size_t kNumPerfCounters =
+    sizeof(kPerfCounters) / sizeof(kPerfCounters[0]);
+static_assert(kNumPerfCounters + 2 == SlowOperationTracker::kNumCounters,
+              "The counters are the PerfContext ones and two IOStatsContext "
+              "ones");
+
+const char* OperationName(SlowOperationType type) {
+  switch (type) {
+    case SlowOperationType::kGet:
+      return "Get";
+    case SlowOperationType::kMultiGet:
+      return "MultiGet";
+    case SlowOperationType::kSeek:
+      return "Seek";
+    case SlowOperationType::kWrite:
+      return "Write";
+    default:
+      assert(false);
+      return "Unknown";
+  }
+}
+}  // namespace
+
+SlowOperationTracker::SlowOperationTracker(
+    const ImmutableDBOptions* db_options, SlowOperationType type,
+    const std::string* cf_name)
+    : type_(type), cf_name_(cf_name) {
+  if (db_options != nullptr && db_options->slow_operation_threshold_micros > 0 &&
+      current_ == nullptr) {
+    db_options_ = db_options;
+    Start();
+  }
+}
+
+void SlowOperationTracker::Snapshot(uint64_t* values) {
+  const PerfContext* perf = get_perf_context();
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    values[i] = perf->*kPerfCounters[i].member;
+  }
+  const IOStatsContext* iostats = get_iostats_context();
+  values[kNumPerfCounters] = iostats->bytes_read;
+  values[kNumPerfCounters + 1] = iostats->read_nanos;
+}
+
+void SlowOperationTracker::Start() {
+  current_ = this;
+  Snapshot(start_values_);
+  start_micros_ = db_options_->clock->NowMicros();
+}
+
+void SlowOperationTracker::Finish() {
+  current_ = nullptr;
+  const uint64_t duration_micros =
+      db_options_->clock->NowMicros() - start_micros_;
+  if (duration_micros < db_options_->slow_operation_threshold_micros) {
+    return;
+  }
+
+  uint64_t end_values[kNumCounters];
+  Snapshot(end_values);
+
+  SlowOperationInfo info;
+  info.type = type_;
+  if (cf_name_ != nullptr) {
+    info.cf_name = *cf_name_;
+  }
+  info.duration_micros = duration_micros;
+  info.sst_files.assign(file_numbers_.begin(), file_numbers_.end());
+  std::sort(info.sst_files.begin(), info.sst_files.end());
+  info.sst_files.erase(
+      std::unique(info.sst_files.begin(), info.sst_files.end()),
+      info.sst_files.end());
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    // The contexts may have been reset by the operation
+    const uint64_t delta = end_values[i] >= start_values_[i]
+                               ? end_values[i] - start_values_[i]
+                               : end_values[i];
+    if (delta == 0) {
+      continue;
+    }
+    if (i < kNumPerfCounters) {
+      info.perf_counters[kPerfCounters[i].name] = delta;
+    } else if (i == kNumPerfCounters) {
+      info.perf_counters["iostats.bytes_read"] = delta;
+    } else {
+      info.perf_counters["iostats.read_nanos"] = delta;
+    }
+  }
+
+  for (const auto& listener : db_options_->listeners) {
+    listener->OnSlowOperation(info);
+  }
+
+  if (db_options_->info_log != nullptr) {
+    std::string files;
+    for (uint64_t file_number : info.sst_files) {
+      files += (files.empty() ? "" : ",") + std::to_string(file_number);
+    }
+    std::string counters;
+    for (const auto& counter : info.perf_counters) {
+      counters += (counters.empty() ? "" : ", ") + counter.first + "=" +
+                  std::to_string(counter.second);
+    }
+    ROCKS_LOG_WARN(db_options_->info_log,
+                   "Slow %s [%s]: %" PRIu64
+                   " micros, SST files read: [%s], counters: {%s}",
+                   OperationName(type_), info.cf_name.c_str(),
+                   duration_micros, files.c_str(), counters.c_str());
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,84 @@
+// Copyright (C) 2023 Speedb Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "rocksdb/listener.h"
+#include "util/autovector.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct ImmutableDBOptions;
+
+// Reports the operation from construction to destruction to the listeners
+// and the info log if it takes at least
+// DBOptions::slow_operation_threshold_micros.
+//
+// Every tracked operation reads the clock and snapshots a fixed set of
+// PerfContext and IOStatsContext counters when it starts, and collects the
+// numbers of the SST files it reads into a small inline vector. Only when the
+// operation turns out to be slow are the counters compared and the
+// SlowOperationInfo built, so fast operations pay for the snapshot and a
+// second clock read only. Operations started by a tracked operation on the
+// same thread (e.g. the batched MultiGet() behind the vector one) are not
+// tracked on their own.
+class SlowOperationTracker {
+ public:
+  // Nothing is tracked if db_options is nullptr. cf_name may be nullptr; it
+  // must outlive the tracker.
+  SlowOperationTracker(const ImmutableDBOptions* db_options,
+                       SlowOperationType type, const std::string* cf_name);
+
+  SlowOperationTracker(const SlowOperationTracker&) = delete;
+  SlowOperationTracker& operator=(const SlowOperationTracker&) = delete;
+
+  ~SlowOperationTracker() {
+    if (db_options_ != nullptr) {
+      Finish();
+    }
+  }
+
+  // Records that the operation tracked on the calling thread, if any, reads
+  // the SST file
+  static void RecordFileRead(uint64_t file_number) {
+    if (current_ != nullptr) {
+      current_->file_numbers_.push_back(file_number);
+    }
+  }
+
+  // The PerfContext and IOStatsContext counters reported for a slow
+  // operation
+  static constexpr size_t kNumCounters = 21;
+
+ private:
+  void Start();
+  void Finish();
+
+  static void Snapshot(uint64_t* values);
+
+  static thread_local SlowOperationTracker* current_;
+
+  // nullptr unless the operation is tracked
+  const ImmutableDBOptions* db_options_ = nullptr;
+  const SlowOperationType type_;
+  const std::string* const cf_name_;
+  uint64_t start_micros_ = 0;
+  uint64_t start_values_[kNumCounters];
+  autovector<uint64_t, 8> file_numbers_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
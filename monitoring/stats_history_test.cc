@@ -345,8 +345,8 @@ TEST_F(StatsHistoryTest, GetStatsHistoryFromDisk) {
     stats_count += stats_map.size();
   }
   ASSERT_EQ(slice_count, 3);
-  // 2 extra keys for format version
-  ASSERT_EQ(stats_count, key_count3 - 2);
+  // 2 extra keys for format version, and one block holding all the snapshots
+  ASSERT_EQ(key_count3, 3);
   // verify reopen will not cause data loss
   ReopenWithColumnFamilies({"default", "pikachu"}, options);
   ASSERT_OK(
@@ -460,7 +460,135 @@ TEST_F(StatsHistoryTest, PersitentStatsVerifyValue) {
   Close();
 }
 
-// TODO(Zhongyi): add test for different format versions
+TEST_F(StatsHistoryTest, PersistentStatsBlockEncoding) {
+  PersistentStatsBlockBuilder builder;
+  std::vector<std::map<std::string, uint64_t>> expected;
+  std::map<std::string, std::string> blocks;
+  for (uint32_t i = 0; i < kStatsSnapshotsPerBlock + 10; ++i) {
+    std::map<std::string, uint64_t> stats;
+    stats["steady"] = 100;
+    stats["growing"] = i * i;
+    // Decreasing values and large jumps
+    stats["jumpy"] = (i % 3 == 0) ? std::numeric_limits<uint64_t>::max() - i : i;
+    if (i >= 5) {
+      // Appears in the middle of the first block
+      stats["late"] = i;
+    }
+    if (i < 3) {
+      // Persisted as 0 once missing
+      stats["early"] = 7;
+    }
+    std::string key;
+    std::string value;
+    builder.Add(1000 + i * 60, stats, &key, &value);
+    blocks[key] = value;
+    if (i >= 3 && i < kStatsSnapshotsPerBlock) {
+      stats["early"] = 0;
+    }
+    expected.push_back(stats);
+  }
+  ASSERT_EQ(2, blocks.size());
+  ASSERT_EQ(EncodeStatsBlockKey(1000), blocks.begin()->first);
+  // A steady stat takes a byte per snapshot
+  ASSERT_LT(blocks.begin()->second.size(),
+            kStatsSnapshotsPerBlock * 5 * sizeof(uint64_t) / 2);
+
+  std::vector<uint64_t> times;
+  std::vector<std::map<std::string, uint64_t>> snapshots;
+  size_t snapshot = 0;
+  for (const auto& block : blocks) {
+    ASSERT_OK(
+        DecodePersistentStatsBlock(block.second, {}, &times, &snapshots));
+    ASSERT_EQ(times.size(), snapshots.size());
+    for (size_t i = 0; i < times.size(); ++i, ++snapshot) {
+      ASSERT_EQ(1000 + snapshot * 60, times[i]);
+      ASSERT_EQ(expected[snapshot], snapshots[i]);
+    }
+  }
+  ASSERT_EQ(expected.size(), snapshot);
+
+  // Only the requested stats are decoded
+  ASSERT_OK(DecodePersistentStatsBlock(blocks.begin()->second,
+                                       {"late", "missing"}, &times,
+                                       &snapshots));
+  ASSERT_EQ(kStatsSnapshotsPerBlock, snapshots.size());
+  ASSERT_TRUE(snapshots[0].empty());
+  ASSERT_EQ((std::map<std::string, uint64_t>{{"late", 5}}), snapshots[5]);
+
+  std::string truncated = blocks.begin()->second;
+  truncated.resize(truncated.size() / 2);
+  ASSERT_TRUE(DecodePersistentStatsBlock(truncated, {}, &times, &snapshots)
+                  .IsCorruption());
+}
+
+TEST_F(StatsHistoryTest, PersistentStatsReadsFormatVersion1) {
+  constexpr int kPeriodSec = 5;
+  Options options;
+  options.create_if_missing = true;
+  options.stats_persist_period_sec = kPeriodSec;
+  options.statistics = CreateDBStatistics();
+  options.persist_stats_to_disk = true;
+  options.env = mock_env_.get();
+  ASSERT_OK(TryReopen(options));
+
+  // Snapshots persisted by a release using format version 1
+  ASSERT_OK(db_->Put(WriteOptions(), dbfull()->PersistentStatsColumnFamily(),
+                     kFormatVersionKeyString, "1"));
+  const std::string kSample = "rocksdb.number.keys.read";
+  for (uint64_t time : {1, 2}) {
+    for (const std::string& name : {kSample, std::string("rocksdb.other")}) {
+      char key[100];
+      int length = EncodePersistentStatsKey(time, name, 100, key);
+      ASSERT_OK(db_->Put(WriteOptions(), dbfull()->PersistentStatsColumnFamily(),
+                         Slice(key, length), std::to_string(time * 10)));
+    }
+  }
+  ASSERT_OK(Put("foo", "bar"));
+  Reopen(options);
+
+  dbfull()->TEST_WaitForPeriodicTaskRun(
+      [&] { mock_clock_->MockSleepForSeconds(kPeriodSec - 1); });
+  ASSERT_EQ("bar", Get("foo"));
+  ASSERT_EQ("bar", Get("foo"));
+  dbfull()->TEST_WaitForPeriodicTaskRun(
+      [&] { mock_clock_->MockSleepForSeconds(kPeriodSec); });
+  dbfull()->TEST_WaitForPeriodicTaskRun(
+      [&] { mock_clock_->MockSleepForSeconds(kPeriodSec); });
+
+  std::unique_ptr<StatsHistoryIterator> stats_iter;
+  ASSERT_OK(db_->GetStatsHistory(0, mock_clock_->NowSeconds(), {kSample},
+                                 &stats_iter));
+  std::vector<uint64_t> times;
+  std::vector<uint64_t> values;
+  for (; stats_iter->Valid(); stats_iter->Next()) {
+    const auto& stats_map = stats_iter->GetStatsMap();
+    ASSERT_EQ(1, stats_map.size());
+    times.push_back(stats_iter->GetStatsTime());
+    values.push_back(stats_map.at(kSample));
+  }
+  ASSERT_OK(stats_iter->status());
+  ASSERT_EQ((std::vector<uint64_t>{1, 2, 2 * kPeriodSec - 1,
+                                   3 * kPeriodSec - 1}),
+            times);
+  ASSERT_EQ((std::vector<uint64_t>{10, 20, 2, 0}), values);
+
+  // A range starting in the middle of a block
+  ASSERT_OK(db_->GetStatsHistory(2 * kPeriodSec, mock_clock_->NowSeconds(),
+                                 &stats_iter));
+  ASSERT_TRUE(stats_iter->Valid());
+  ASSERT_EQ(3 * kPeriodSec - 1, stats_iter->GetStatsTime());
+  ASSERT_EQ(0, stats_iter->GetStatsMap().at(kSample));
+  ASSERT_GT(stats_iter->GetStatsMap().size(), 1);
+  stats_iter->Next();
+  ASSERT_FALSE(stats_iter->Valid());
+  ASSERT_OK(stats_iter->status());
+
+  uint64_t format_version = 0;
+  ASSERT_OK(DecodePersistentStatsVersionNumber(
+      dbfull(), StatsVersionKeyType::kFormatVersion, &format_version));
+  ASSERT_EQ(kStatsCFCurrentFormatVersion, format_version);
+  Close();
+}
 
 TEST_F(StatsHistoryTest, PersistentStatsCreateColumnFamilies) {
   constexpr int kPeriodSec = 5;
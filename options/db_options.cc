@@ -320,6 +320,19 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, persist_stats_to_disk),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"enable_cf_latency_stats",
+         {offsetof(struct ImmutableDBOptions, enable_cf_latency_stats),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"perf_context_sample_rate",
+         {offsetof(struct ImmutableDBOptions, perf_context_sample_rate),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"slow_operation_threshold_micros",
+         {offsetof(struct ImmutableDBOptions,
+                   slow_operation_threshold_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"fail_if_options_file_error",
          {offsetof(struct ImmutableDBOptions, fail_if_options_file_error),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -400,6 +413,14 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, wal_compression),
           OptionType::kCompressionType, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"wal_compression_threads",
+         {offsetof(struct ImmutableDBOptions, wal_compression_threads),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"enable_pipelined_wal_recovery",
+         {offsetof(struct ImmutableDBOptions, enable_pipelined_wal_recovery),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"seq_per_batch",
          {0, OptionType::kBoolean, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kNone}},
@@ -764,9 +785,14 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       two_write_queues(options.two_write_queues),
       manual_wal_flush(options.manual_wal_flush),
       wal_compression(options.wal_compression),
+      wal_compression_threads(options.wal_compression_threads),
+      enable_pipelined_wal_recovery(options.enable_pipelined_wal_recovery),
       atomic_flush(options.atomic_flush),
       avoid_unnecessary_blocking_io(options.avoid_unnecessary_blocking_io),
       persist_stats_to_disk(options.persist_stats_to_disk),
+      enable_cf_latency_stats(options.enable_cf_latency_stats),
+      perf_context_sample_rate(options.perf_context_sample_rate),
+      slow_operation_threshold_micros(options.slow_operation_threshold_micros),
       write_dbid_to_manifest(options.write_dbid_to_manifest),
       log_readahead_size(options.log_readahead_size),
       file_checksum_gen_factory(options.file_checksum_gen_factory),
@@ -932,12 +958,24 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    manual_wal_flush);
   ROCKS_LOG_HEADER(log, "            Options.wal_compression: %d",
                    wal_compression);
+  ROCKS_LOG_HEADER(log, "            Options.wal_compression_threads: %d",
+                   wal_compression_threads);
+  ROCKS_LOG_HEADER(log, "            Options.enable_pipelined_wal_recovery: %d",
+                   enable_pipelined_wal_recovery);
   ROCKS_LOG_HEADER(log, "            Options.atomic_flush: %d", atomic_flush);
   ROCKS_LOG_HEADER(log,
                    "            Options.avoid_unnecessary_blocking_io: %d",
                    avoid_unnecessary_blocking_io);
   ROCKS_LOG_HEADER(log, "                Options.persist_stats_to_disk: %u",
                    persist_stats_to_disk);
+  ROCKS_LOG_HEADER(log, "              Options.enable_cf_latency_stats: %d",
+                   enable_cf_latency_stats);
+  ROCKS_LOG_HEADER(log,
+                   "             Options.perf_context_sample_rate: %" PRIu32,
+                   perf_context_sample_rate);
+  ROCKS_LOG_HEADER(log,
+                   "      Options.slow_operation_threshold_micros: %" PRIu64,
+                   slow_operation_threshold_micros);
   ROCKS_LOG_HEADER(log, "                Options.write_dbid_to_manifest: %d",
                    write_dbid_to_manifest);
   ROCKS_LOG_HEADER(
@@ -86,9 +86,14 @@ struct ImmutableDBOptions {
   bool two_write_queues;
   bool manual_wal_flush;
   CompressionType wal_compression;
+  int wal_compression_threads;
+  bool enable_pipelined_wal_recovery;
   bool atomic_flush;
   bool avoid_unnecessary_blocking_io;
   bool persist_stats_to_disk;
+  bool enable_cf_latency_stats;
+  uint32_t perf_context_sample_rate;
+  uint64_t slow_operation_threshold_micros;
   bool write_dbid_to_manifest;
   size_t log_readahead_size;
   std::shared_ptr<FileChecksumGenFactory> file_checksum_gen_factory;
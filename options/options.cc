@@ -109,6 +109,8 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
           options.blob_garbage_collection_age_cutoff),
       blob_garbage_collection_force_threshold(
           options.blob_garbage_collection_force_threshold),
+      blob_garbage_collection_force_max_batches(
+          options.blob_garbage_collection_force_max_batches),
       blob_compaction_readahead_size(options.blob_compaction_readahead_size),
       blob_file_starting_level(options.blob_file_starting_level),
       blob_cache(options.blob_cache),
@@ -227,6 +229,11 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
         log,
         "        Options.bottommost_compression_opts.use_zstd_dict_trainer: %s",
         bottommost_compression_opts.use_zstd_dict_trainer ? "true" : "false");
+    ROCKS_LOG_HEADER(
+        log,
+        "      Options.bottommost_compression_opts.reuse_dict_across_files: %s",
+        bottommost_compression_opts.reuse_dict_across_files ? "true"
+                                                            : "false");
     ROCKS_LOG_HEADER(log, "           Options.compression_opts.window_bits: %d",
                      compression_opts.window_bits);
     ROCKS_LOG_HEADER(log, "                 Options.compression_opts.level: %d",
@@ -244,6 +251,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(
         log, "        Options.compression_opts.use_zstd_dict_trainer: %s",
         compression_opts.use_zstd_dict_trainer ? "true" : "false");
+    ROCKS_LOG_HEADER(
+        log, "      Options.compression_opts.reuse_dict_across_files: %s",
+        compression_opts.reuse_dict_across_files ? "true" : "false");
     ROCKS_LOG_HEADER(log,
                      "        Options.compression_opts.parallel_threads: "
                      "%" PRIu32,
@@ -429,6 +439,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                      blob_garbage_collection_age_cutoff);
     ROCKS_LOG_HEADER(log, "Options.blob_garbage_collection_force_threshold: %f",
                      blob_garbage_collection_force_threshold);
+    ROCKS_LOG_HEADER(
+        log, "Options.blob_garbage_collection_force_max_batches: %" PRIu32,
+        blob_garbage_collection_force_max_batches);
     ROCKS_LOG_HEADER(
         log, "         Options.blob_compaction_readahead_size: %" PRIu64,
         blob_compaction_readahead_size);
@@ -110,6 +110,12 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.stats_persist_period_sec =
       mutable_db_options.stats_persist_period_sec;
   options.persist_stats_to_disk = immutable_db_options.persist_stats_to_disk;
+  options.enable_cf_latency_stats =
+      immutable_db_options.enable_cf_latency_stats;
+  options.perf_context_sample_rate =
+      immutable_db_options.perf_context_sample_rate;
+  options.slow_operation_threshold_micros =
+      immutable_db_options.slow_operation_threshold_micros;
   options.stats_history_buffer_size =
       mutable_db_options.stats_history_buffer_size;
   options.advise_random_on_open = immutable_db_options.advise_random_on_open;
@@ -160,6 +166,10 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.two_write_queues = immutable_db_options.two_write_queues;
   options.manual_wal_flush = immutable_db_options.manual_wal_flush;
   options.wal_compression = immutable_db_options.wal_compression;
+  options.wal_compression_threads =
+      immutable_db_options.wal_compression_threads;
+  options.enable_pipelined_wal_recovery =
+      immutable_db_options.enable_pipelined_wal_recovery;
   options.atomic_flush = immutable_db_options.atomic_flush;
   options.avoid_unnecessary_blocking_io =
       immutable_db_options.avoid_unnecessary_blocking_io;
@@ -254,6 +264,8 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
       moptions.blob_garbage_collection_age_cutoff;
   cf_opts->blob_garbage_collection_force_threshold =
       moptions.blob_garbage_collection_force_threshold;
+  cf_opts->blob_garbage_collection_force_max_batches =
+      moptions.blob_garbage_collection_force_max_batches;
   cf_opts->blob_compaction_readahead_size =
       moptions.blob_compaction_readahead_size;
   cf_opts->blob_file_starting_level = moptions.blob_file_starting_level;
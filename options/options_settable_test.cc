@@ -335,6 +335,9 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "stats_dump_period_sec=70127;"
                              "stats_persist_period_sec=54321;"
                              "persist_stats_to_disk=true;"
+                             "enable_cf_latency_stats=false;"
+                             "perf_context_sample_rate=0;"
+                             "slow_operation_threshold_micros=0;"
                              "stats_history_buffer_size=14159;"
                              "allow_fallocate=true;"
                              "allow_mmap_reads=false;"
@@ -362,6 +365,8 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "two_write_queues=false;"
                              "manual_wal_flush=false;"
                              "wal_compression=kZSTD;"
+                             "wal_compression_threads=2;"
+                             "enable_pipelined_wal_recovery=false;"
                              "seq_per_batch=false;"
                              "atomic_flush=false;"
                              "avoid_unnecessary_blocking_io=false;"
@@ -510,8 +515,14 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "max_bytes_for_level_multiplier=60;"
       "memtable_factory=SkipListFactory;"
       "compression=kNoCompression;"
-      "compression_opts=5:6:7:8:9:10:true:11:false;"
-      "bottommost_compression_opts=4:5:6:7:8:9:true:10:true;"
+      "compression_opts={window_bits=5;level=6;strategy=7;max_dict_bytes=8;"
+      "zstd_max_train_bytes=9;parallel_threads=10;enabled=true;"
+      "max_dict_buffer_bytes=11;use_zstd_dict_trainer=false;"
+      "reuse_dict_across_files=true};"
+      "bottommost_compression_opts={window_bits=4;level=5;strategy=6;"
+      "max_dict_bytes=7;zstd_max_train_bytes=8;parallel_threads=9;"
+      "enabled=true;max_dict_buffer_bytes=10;use_zstd_dict_trainer=true;"
+      "reuse_dict_across_files=true};"
       "bottommost_compression=kDisableCompressionOption;"
       "level0_stop_writes_trigger=33;"
       "num_levels=99;"
@@ -549,6 +560,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "enable_blob_garbage_collection=true;"
       "blob_garbage_collection_age_cutoff=0.5;"
       "blob_garbage_collection_force_threshold=0.75;"
+      "blob_garbage_collection_force_max_batches=4;"
       "blob_compaction_readahead_size=262144;"
       "blob_file_starting_level=1;"
       "prepopulate_blob_cache=kDisable;"
@@ -1215,6 +1215,14 @@ TEST_F(OptionsTest, GetMemTableRepFactoryFromString) {
   ASSERT_NOK(GetMemTableRepFactoryFromString("hash_linkedlist:1000:invalid_opt",
                                              &new_mem_factory));
 
+  ASSERT_OK(GetMemTableRepFactoryFromString("sharded_skip_list",
+                                            &new_mem_factory));
+  ASSERT_OK(GetMemTableRepFactoryFromString("sharded_skip_list:4",
+                                            &new_mem_factory));
+  ASSERT_STREQ(new_mem_factory->Name(), "ShardedSkipListRepFactory");
+  ASSERT_NOK(GetMemTableRepFactoryFromString("sharded_skip_list:4:invalid_opt",
+                                             &new_mem_factory));
+
   ASSERT_OK(GetMemTableRepFactoryFromString("vector", &new_mem_factory));
   ASSERT_OK(GetMemTableRepFactoryFromString("vector:1024", &new_mem_factory));
   ASSERT_EQ(std::string(new_mem_factory->Name()), "VectorRepFactory");
@@ -1296,6 +1304,33 @@ TEST_F(OptionsTest, MemTableRepFactoryCreateFromString) {
       "logging_threshold=12; log_when_flash=true; invalid=unknown",
       &new_mem_factory));
 
+  std::string num_shards;
+  ASSERT_OK(MemTableRepFactory::CreateFromString(
+      config_options, "sharded_skip_list", &new_mem_factory));
+  ASSERT_OK(new_mem_factory->GetOption(config_options, "num_shards",
+                                       &num_shards));
+  ASSERT_EQ(num_shards, "8");
+  ASSERT_OK(MemTableRepFactory::CreateFromString(
+      config_options, "sharded_skip_list:4", &new_mem_factory));
+  ASSERT_STREQ(new_mem_factory->Name(), "ShardedSkipListRepFactory");
+  ASSERT_TRUE(new_mem_factory->IsInstanceOf("sharded_skip_list"));
+  ASSERT_TRUE(new_mem_factory->IsInstanceOf("ShardedSkipListRepFactory"));
+  ASSERT_TRUE(new_mem_factory->IsInsertConcurrentlySupported());
+  ASSERT_OK(new_mem_factory->GetOption(config_options, "num_shards",
+                                       &num_shards));
+  ASSERT_EQ(num_shards, "4");
+  ASSERT_NOK(MemTableRepFactory::CreateFromString(
+      config_options, "sharded_skip_list:4:invalid_opt", &new_mem_factory));
+  ASSERT_OK(MemTableRepFactory::CreateFromString(
+      config_options, "id=sharded_skip_list; num_shards=16",
+      &new_mem_factory));
+  ASSERT_OK(new_mem_factory->GetOption(config_options, "num_shards",
+                                       &num_shards));
+  ASSERT_EQ(num_shards, "16");
+  ASSERT_NOK(MemTableRepFactory::CreateFromString(
+      config_options, "id=sharded_skip_list; invalid=unknown",
+      &new_mem_factory));
+
   ASSERT_OK(MemTableRepFactory::CreateFromString(config_options, "vector",
                                                  &new_mem_factory));
   ASSERT_OK(MemTableRepFactory::CreateFromString(config_options, "vector:1024",
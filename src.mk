@@ -136,17 +136,21 @@ LIB_SOURCES =                                                   \
   memtable/hash_linklist_rep.cc                                 \
   memtable/hash_spdb_rep.cc                                     \
   memtable/hash_skiplist_rep.cc                                 \
+  memtable/sharded_skiplist_rep.cc                              \
   memtable/skiplistrep.cc                                       \
   memtable/vectorrep.cc                                         \
   memtable/write_buffer_manager.cc                              \
+  monitoring/cf_operation_stats.cc                              \
   monitoring/histogram.cc                                       \
   monitoring/histogram_windowing.cc                             \
   monitoring/in_memory_stats_history.cc                         \
   monitoring/instrumented_mutex.cc                              \
   monitoring/iostats_context.cc                                 \
   monitoring/perf_context.cc                                    \
+  monitoring/perf_context_sampler.cc                            \
   monitoring/perf_level.cc                                      \
   monitoring/persistent_stats_history.cc                        \
+  monitoring/slow_operation_tracker.cc                          \
   monitoring/statistics.cc                                      \
   monitoring/thread_status_impl.cc                              \
   monitoring/thread_status_updater.cc                           \
@@ -307,6 +311,7 @@ LIB_SOURCES =                                                   \
   utilities/transactions/lock/lock_manager.cc                   \
   utilities/transactions/lock/point/point_lock_tracker.cc       \
   utilities/transactions/lock/point/point_lock_manager.cc       \
+  utilities/transactions/optimistic_key_version_cache.cc        \
   utilities/transactions/optimistic_transaction.cc              \
   utilities/transactions/optimistic_transaction_db_impl.cc      \
   utilities/transactions/pessimistic_transaction.cc             \
@@ -636,6 +641,7 @@ TEST_MAIN_SOURCES_C = \
 MICROBENCH_SOURCES =                                          \
   microbench/ribbon_bench.cc                                  \
   microbench/db_basic_bench.cc                                  \
+  microbench/published_version_bench.cc                         \
 
 JNI_NATIVE_SOURCES =                                          \
   java/rocksjni/backupenginejni.cc                            \
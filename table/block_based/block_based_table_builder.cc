@@ -322,6 +322,8 @@ struct BlockBasedTableBuilder::Rep {
   uint64_t buffer_limit;
   std::shared_ptr<CacheReservationManager>
       compression_dict_buffer_cache_res_mgr;
+  // See TableBuilderOptions::shared_compression_dict
+  std::string* shared_compression_dict;
   const bool use_delta_encoding_for_index_values;
   std::unique_ptr<FilterBlockBuilder> filter_builder;
   OffsetableCacheKey base_cache_key;
@@ -344,6 +346,14 @@ struct BlockBasedTableBuilder::Rep {
     return compression_opts.parallel_threads > 1;
   }
 
+  void SetCompressionDict(const std::string& dict) {
+    compression_dict.reset(
+        new CompressionDict(dict, compression_type, compression_opts.level));
+    verify_dict.reset(new UncompressionDict(
+        dict, compression_type == kZSTD ||
+                  compression_type == kZSTDNotFinalCompression));
+  }
+
   Status GetStatus() {
     // We need to make modifications of status visible when status_ok is set
     // to false, and this is ensured by status_mutex, so no special memory
@@ -438,6 +448,7 @@ struct BlockBasedTableBuilder::Rep {
         verify_dict(),
         state((tbo.compression_opts.max_dict_bytes > 0) ? State::kBuffered
                                                         : State::kUnbuffered),
+        shared_compression_dict(tbo.shared_compression_dict),
         use_delta_encoding_for_index_values(table_opt.format_version >= 4 &&
                                             !table_opt.block_align),
         reason(tbo.reason),
@@ -478,6 +489,13 @@ struct BlockBasedTableBuilder::Rep {
     for (uint32_t i = 0; i < compression_opts.parallel_threads; i++) {
       compression_ctxs[i].reset(new CompressionContext(compression_type));
     }
+    if (state == State::kBuffered && shared_compression_dict != nullptr &&
+        !shared_compression_dict->empty()) {
+      // An earlier file of the same compaction output level has built the
+      // dictionary, so compress with it right away.
+      SetCompressionDict(*shared_compression_dict);
+      state = State::kUnbuffered;
+    }
     if (table_options.index_type ==
         BlockBasedTableOptions::kTwoLevelIndexSearch) {
       p_index_builder_ = PartitionedIndexBuilder::CreateIndexBuilder(
@@ -1784,11 +1802,11 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
   } else {
     dict = std::move(compression_dict_samples);
   }
-  r->compression_dict.reset(new CompressionDict(dict, r->compression_type,
-                                                r->compression_opts.level));
-  r->verify_dict.reset(new UncompressionDict(
-      dict, r->compression_type == kZSTD ||
-                r->compression_type == kZSTDNotFinalCompression));
+  r->SetCompressionDict(dict);
+  if (r->shared_compression_dict != nullptr &&
+      r->shared_compression_dict->empty()) {
+    *r->shared_compression_dict = dict;
+  }
 
   auto get_iterator_for_block = [&r](size_t i) {
     auto& data_block = r->data_block_buffers[i];
@@ -162,6 +162,48 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::RetrieveMultipleBlocks)
     }
   }
 
+  // Verify the checksums of all the blocks read in full in one pass, instead
+  // of timing and verifying each block while it is processed below.
+  // checksum_idx_for_block[i] is the index of the checksum status of the i-th
+  // non-null handle, or kNotVerified.
+  constexpr size_t kNotVerified = MultiGetContext::MAX_BATCH_SIZE;
+  std::array<size_t, MultiGetContext::MAX_BATCH_SIZE> checksum_idx_for_block;
+  std::array<Status, MultiGetContext::MAX_BATCH_SIZE> checksum_statuses;
+  if (options.verify_checksums) {
+    std::array<const char*, MultiGetContext::MAX_BATCH_SIZE> block_data;
+    std::array<size_t, MultiGetContext::MAX_BATCH_SIZE> block_sizes;
+    std::array<uint64_t, MultiGetContext::MAX_BATCH_SIZE> block_offsets;
+    size_t num_to_verify = 0;
+    size_t block_idx = 0;
+    for (const BlockHandle& handle : *handles) {
+      if (handle.IsNull()) {
+        continue;
+      }
+      assert(block_idx < checksum_idx_for_block.size());
+      const FSReadRequest& req = read_reqs[req_idx_for_block[block_idx]];
+      const size_t req_offset = req_offset_for_block[block_idx];
+      if (req.status.ok() && req.result.size() == req.len &&
+          req_offset + BlockSizeWithTrailer(handle) <= req.result.size()) {
+        // Since the scratch might be shared, the offset of the data block in
+        // the buffer might not be 0. req.result.data() only point to the
+        // begin address of each read request, we need to add the offset
+        // in each read request. Checksum is stored in the block trailer,
+        // beyond the payload size.
+        block_data[num_to_verify] = req.result.data() + req_offset;
+        block_sizes[num_to_verify] = handle.size();
+        block_offsets[num_to_verify] = handle.offset();
+        checksum_idx_for_block[block_idx] = num_to_verify++;
+      } else {
+        checksum_idx_for_block[block_idx] = kNotVerified;
+      }
+      block_idx++;
+    }
+    VerifyBlockChecksums(footer.checksum_type(), num_to_verify,
+                         block_data.data(), block_sizes.data(),
+                         block_offsets.data(), rep_->file->file_name(),
+                         checksum_statuses.data());
+  }
+
   idx_in_batch = 0;
   size_t valid_batch_idx = 0;
   for (auto mget_iter = batch->begin(); mget_iter != batch->end();
@@ -177,6 +219,9 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::RetrieveMultipleBlocks)
     assert(req_idx_for_block[valid_batch_idx] < read_reqs.size());
     size_t& req_idx = req_idx_for_block[valid_batch_idx];
     size_t& req_offset = req_offset_for_block[valid_batch_idx];
+    const size_t checksum_idx = options.verify_checksums
+                                    ? checksum_idx_for_block[valid_batch_idx]
+                                    : kNotVerified;
     valid_batch_idx++;
     FSReadRequest& req = read_reqs[req_idx];
     Status s = req.status;
@@ -213,16 +258,9 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::RetrieveMultipleBlocks)
 #endif
 
       if (options.verify_checksums) {
-        PERF_TIMER_GUARD(block_checksum_time);
-        const char* data = req.result.data();
-        // Since the scratch might be shared, the offset of the data block in
-        // the buffer might not be 0. req.result.data() only point to the
-        // begin address of each read request, we need to add the offset
-        // in each read request. Checksum is stored in the block trailer,
-        // beyond the payload size.
-        s = VerifyBlockChecksum(footer.checksum_type(), data + req_offset,
-                                handle.size(), rep_->file->file_name(),
-                                handle.offset());
+        // The block was read in full, so its checksum was verified above
+        assert(checksum_idx != kNotVerified);
+        s = checksum_statuses[checksum_idx];
         TEST_SYNC_POINT_CALLBACK("RetrieveMultipleBlocks:VerifyChecksum", &s);
       }
     } else if (!use_shared_buffer) {
@@ -22,11 +22,10 @@ void ForceReleaseCachedEntry(void* arg, void* h) {
   cache->Release(handle, true /* erase_if_last_ref */);
 }
 
-// WART: this is specific to block-based table
-Status VerifyBlockChecksum(ChecksumType type, const char* data,
-                           size_t block_size, const std::string& file_name,
-                           uint64_t offset) {
-  PERF_TIMER_GUARD(block_checksum_time);
+namespace {
+Status VerifyBlockChecksumImpl(ChecksumType type, const char* data,
+                               size_t block_size, const std::string& file_name,
+                               uint64_t offset) {
   // After block_size bytes is compression type (1 byte), which is part of
   // the checksummed section.
   size_t len = block_size + 1;
@@ -49,4 +48,24 @@ Status VerifyBlockChecksum(ChecksumType type, const char* data,
         std::to_string(offset) + " size " + std::to_string(block_size));
   }
 }
+}  // namespace
+
+// WART: this is specific to block-based table
+Status VerifyBlockChecksum(ChecksumType type, const char* data,
+                           size_t block_size, const std::string& file_name,
+                           uint64_t offset) {
+  PERF_TIMER_GUARD(block_checksum_time);
+  return VerifyBlockChecksumImpl(type, data, block_size, file_name, offset);
+}
+
+void VerifyBlockChecksums(ChecksumType type, size_t num_blocks,
+                          const char* const* data, const size_t* block_sizes,
+                          const uint64_t* offsets,
+                          const std::string& file_name, Status* statuses) {
+  PERF_TIMER_GUARD(block_checksum_time);
+  for (size_t i = 0; i < num_blocks; ++i) {
+    statuses[i] = VerifyBlockChecksumImpl(type, data[i], block_sizes[i],
+                                          file_name, offsets[i]);
+  }
+}
 }  // namespace ROCKSDB_NAMESPACE
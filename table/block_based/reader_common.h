@@ -28,4 +28,15 @@ extern Status VerifyBlockChecksum(ChecksumType type, const char* data,
                                   size_t block_size,
                                   const std::string& file_name,
                                   uint64_t offset);
+
+// Verifies the checksums of num_blocks blocks read together, setting
+// statuses[i] to VerifyBlockChecksum(type, data[i], block_sizes[i], file_name,
+// offsets[i]). The blocks are verified in a single pass, timed once for the
+// whole batch.
+extern void VerifyBlockChecksums(ChecksumType type, size_t num_blocks,
+                                 const char* const* data,
+                                 const size_t* block_sizes,
+                                 const uint64_t* offsets,
+                                 const std::string& file_name,
+                                 Status* statuses);
 }  // namespace ROCKSDB_NAMESPACE
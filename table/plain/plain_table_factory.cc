@@ -206,6 +206,20 @@ static int RegisterBuiltinMemTableRepFactory(ObjectLibrary& library,
         }
         return guard->get();
       });
+  library.AddFactory<MemTableRepFactory>(
+      AsPattern("ShardedSkipListRepFactory", "sharded_skip_list"),
+      [](const std::string& uri, std::unique_ptr<MemTableRepFactory>* guard,
+         std::string* /*errmsg*/) {
+        // Expecting format: sharded_skip_list:<num_shards>
+        auto colon = uri.find(":");
+        if (colon != std::string::npos) {
+          size_t num_shards = ParseSizeT(uri.substr(colon + 1));
+          guard->reset(NewShardedSkipListRepFactory(num_shards));
+        } else {
+          guard->reset(NewShardedSkipListRepFactory());
+        }
+        return guard->get();
+      });
   library.AddFactory<MemTableRepFactory>(
       AsPattern("HashSkipListRepFactory", "prefix_hash"),
       [](const std::string& uri, std::unique_ptr<MemTableRepFactory>* guard,
@@ -5,16 +5,20 @@
 
 #include "rocksdb/sst_file_writer.h"
 
+#include <algorithm>
+#include <deque>
 #include <vector>
 
 #include "db/db_impl/db_impl.h"
 #include "db/dbformat.h"
 #include "file/writable_file_writer.h"
+#include "port/port.h"
 #include "rocksdb/file_system.h"
 #include "rocksdb/table.h"
 #include "table/block_based/block_based_table_builder.h"
 #include "table/sst_file_writer_collectors.h"
 #include "test_util/sync_point.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -421,4 +425,250 @@ Status SstFileWriter::Finish(ExternalSstFileInfo* file_info) {
 
 uint64_t SstFileWriter::FileSize() { return rep_->file_info.file_size; }
 
+struct ParallelSstFileWriter::Rep {
+  struct Entry {
+    ValueType type;
+    std::string key;
+    std::string value;
+  };
+
+  struct Chunk {
+    size_t index;
+    // Only the first num_entries are part of the chunk, the others are spare
+    // buffers of an earlier chunk
+    std::vector<Entry> entries;
+    size_t num_entries;
+  };
+
+  Rep(const EnvOptions& _env_options, const Options& _options,
+      const std::string& _file_path_prefix, uint64_t _target_file_size,
+      int _num_threads, ColumnFamilyHandle* _cfh)
+      : env_options(_env_options),
+        options(_options),
+        file_path_prefix(_file_path_prefix),
+        target_file_size(std::max<uint64_t>(_target_file_size, 1)),
+        max_queued_chunks(2 * static_cast<size_t>(std::max(_num_threads, 1))),
+        cfh(_cfh),
+        cv(&mu) {
+    const int num_threads = std::max(_num_threads, 1);
+    threads.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      threads.emplace_back(&Rep::BackgroundWork, this);
+    }
+  }
+
+  ~Rep() { StopThreads(); }
+
+  EnvOptions env_options;
+  Options options;
+  std::string file_path_prefix;
+  uint64_t target_file_size;
+  size_t max_queued_chunks;
+  ColumnFamilyHandle* cfh;
+
+  // Only accessed by the writing thread
+  std::vector<Entry> current;
+  size_t num_current = 0;
+  uint64_t current_size = 0;
+  size_t num_chunks = 0;
+  std::string last_key;
+  bool finished = false;
+
+  // Protected by mu
+  port::Mutex mu;
+  port::CondVar cv;
+  std::deque<Chunk> queue;
+  // Entries of written chunks, whose strings Add() reuses
+  std::vector<std::vector<Entry>> free_entries;
+  std::vector<ExternalSstFileInfo> results;
+  Status bg_status;
+  bool shutdown = false;
+
+  std::vector<port::Thread> threads;
+
+  std::string FileName(size_t index) const {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%06" ROCKSDB_PRIszt ".sst", index + 1);
+    return file_path_prefix + buf;
+  }
+
+  Status Add(const Slice& user_key, const Slice& value, ValueType type) {
+    if (finished) {
+      return Status::InvalidArgument("ParallelSstFileWriter is finished");
+    }
+    if (options.comparator->timestamp_size() != 0) {
+      return Status::InvalidArgument("Timestamp size mismatch");
+    }
+    if ((num_chunks > 0 || num_current > 0) &&
+        options.comparator->Compare(user_key, last_key) <= 0) {
+      return Status::InvalidArgument(
+          "Keys must be added in strict ascending order.");
+    }
+    last_key.assign(user_key.data(), user_key.size());
+    if (num_current == current.size()) {
+      current.emplace_back();
+    }
+    Entry& entry = current[num_current++];
+    entry.type = type;
+    entry.key.assign(user_key.data(), user_key.size());
+    entry.value.assign(value.data(), value.size());
+    current_size += user_key.size() + value.size();
+    if (current_size >= target_file_size) {
+      return Flush();
+    }
+    return Status::OK();
+  }
+
+  // Hands the buffered entries to the background threads, waiting for room
+  // in the queue.
+  Status Flush() {
+    if (num_current == 0) {
+      return Status::OK();
+    }
+    MutexLock l(&mu);
+    while (bg_status.ok() && queue.size() >= max_queued_chunks) {
+      cv.Wait();
+    }
+    if (!bg_status.ok()) {
+      return bg_status;
+    }
+    queue.push_back({num_chunks++, std::move(current), num_current});
+    results.resize(num_chunks);
+    if (!free_entries.empty()) {
+      current = std::move(free_entries.back());
+      free_entries.pop_back();
+    } else {
+      current.clear();
+    }
+    num_current = 0;
+    current_size = 0;
+    cv.SignalAll();
+    return Status::OK();
+  }
+
+  void BackgroundWork() {
+    MutexLock l(&mu);
+    while (true) {
+      while (!shutdown && queue.empty()) {
+        cv.Wait();
+      }
+      if (queue.empty()) {
+        return;
+      }
+      Chunk chunk = std::move(queue.front());
+      queue.pop_front();
+      // Room has opened up for the writer
+      cv.SignalAll();
+      if (!bg_status.ok()) {
+        continue;
+      }
+
+      ExternalSstFileInfo info;
+      Status s;
+      {
+        mu.Unlock();
+        s = WriteChunk(chunk, &info);
+        mu.Lock();
+      }
+      free_entries.push_back(std::move(chunk.entries));
+      if (s.ok()) {
+        results[chunk.index] = std::move(info);
+      } else if (bg_status.ok()) {
+        bg_status = s;
+        cv.SignalAll();
+      }
+    }
+  }
+
+  Status WriteChunk(const Chunk& chunk, ExternalSstFileInfo* info) {
+    TEST_SYNC_POINT("ParallelSstFileWriter::WriteChunk");
+    SstFileWriter writer(env_options, options, cfh);
+    Status s = writer.Open(FileName(chunk.index));
+    for (size_t i = 0; s.ok() && i < chunk.num_entries; ++i) {
+      const Entry& e = chunk.entries[i];
+      switch (e.type) {
+        case kTypeValue:
+          s = writer.Put(e.key, e.value);
+          break;
+        case kTypeMerge:
+          s = writer.Merge(e.key, e.value);
+          break;
+        case kTypeDeletion:
+          s = writer.Delete(e.key);
+          break;
+        default:
+          assert(false);
+          s = Status::Corruption("Unexpected value type");
+      }
+    }
+    if (s.ok()) {
+      s = writer.Finish(info);
+    }
+    return s;
+  }
+
+  void StopThreads() {
+    {
+      MutexLock l(&mu);
+      shutdown = true;
+      cv.SignalAll();
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    threads.clear();
+  }
+};
+
+ParallelSstFileWriter::ParallelSstFileWriter(
+    const EnvOptions& env_options, const Options& options,
+    const std::string& file_path_prefix, uint64_t target_file_size,
+    int num_threads, ColumnFamilyHandle* column_family)
+    : rep_(new Rep(env_options, options, file_path_prefix, target_file_size,
+                   num_threads, column_family)) {}
+
+ParallelSstFileWriter::~ParallelSstFileWriter() {
+  if (!rep_->finished) {
+    // Skip the chunks that were not picked up yet
+    MutexLock l(&rep_->mu);
+    rep_->queue.clear();
+    if (rep_->bg_status.ok()) {
+      rep_->bg_status = Status::Aborted("ParallelSstFileWriter destroyed");
+    }
+  }
+}
+
+Status ParallelSstFileWriter::Put(const Slice& user_key, const Slice& value) {
+  return rep_->Add(user_key, value, ValueType::kTypeValue);
+}
+
+Status ParallelSstFileWriter::Merge(const Slice& user_key, const Slice& value) {
+  return rep_->Add(user_key, value, ValueType::kTypeMerge);
+}
+
+Status ParallelSstFileWriter::Delete(const Slice& user_key) {
+  return rep_->Add(user_key, Slice(), ValueType::kTypeDeletion);
+}
+
+Status ParallelSstFileWriter::Finish(
+    std::vector<ExternalSstFileInfo>* file_info) {
+  Rep* r = rep_.get();
+  if (r->finished) {
+    return Status::InvalidArgument("ParallelSstFileWriter is finished");
+  }
+  if (r->num_chunks == 0 && r->num_current == 0) {
+    return Status::InvalidArgument("Cannot create sst file with no entries");
+  }
+  Status s = r->Flush();
+  r->finished = true;
+  r->StopThreads();
+  if (s.ok()) {
+    s = r->bg_status;
+  }
+  if (s.ok() && file_info != nullptr) {
+    *file_info = std::move(r->results);
+  }
+  return s;
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -151,6 +151,12 @@ struct TableBuilderOptions {
   // in the table options of the ioptions.table_factory
   bool skip_filters = false;
   const uint64_t cur_file_num;
+
+  // Compression dictionary shared by the table files of one compaction output
+  // level (see CompressionOptions::reuse_dict_across_files), or nullptr. A
+  // builder compresses with the dictionary if it is not empty, and otherwise
+  // stores the dictionary it builds here for the next files.
+  std::string* shared_compression_dict = nullptr;
 };
 
 // TableBuilder provides the interface used to build a Table
@@ -65,6 +65,7 @@
 #include "rocksdb/stats_history.h"
 #include "rocksdb/table.h"
 #include "rocksdb/table_pinning_policy.h"
+#include "rocksdb/trace_record_result.h"
 #include "rocksdb/utilities/backup_engine.h"
 #include "rocksdb/utilities/db_ttl.h"
 #include "rocksdb/utilities/object_registry.h"
@@ -992,6 +993,15 @@ DEFINE_string(wal_compression, "none",
 static enum ROCKSDB_NAMESPACE::CompressionType FLAGS_wal_compression_e =
     ROCKSDB_NAMESPACE::kNoCompression;
 
+DEFINE_int32(wal_compression_threads,
+             ROCKSDB_NAMESPACE::Options().wal_compression_threads,
+             "Number of helper threads compressing large WAL records. 0 to "
+             "compress on the writing thread.");
+
+DEFINE_bool(enable_pipelined_wal_recovery,
+            ROCKSDB_NAMESPACE::Options().enable_pipelined_wal_recovery,
+            "If true, read WAL records on a separate thread during recovery.");
+
 DEFINE_string(wal_dir, "", "If not empty, use the given dir for WAL");
 
 DEFINE_string(truth_db, "/dev/shm/truth_db/dbbench",
@@ -1246,6 +1256,12 @@ DEFINE_double(blob_garbage_collection_force_threshold,
               "[Integrated BlobDB] The threshold for the ratio of garbage in "
               "the oldest blob files for forcing garbage collection.");
 
+DEFINE_uint32(blob_garbage_collection_force_max_batches,
+              ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
+                  .blob_garbage_collection_force_max_batches,
+              "[Integrated BlobDB] The maximum number of batches of the oldest "
+              "blob files considered for forcing garbage collection.");
+
 DEFINE_uint64(blob_compaction_readahead_size,
               ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
                   .blob_compaction_readahead_size,
@@ -1318,6 +1334,12 @@ DEFINE_int64(
 DEFINE_string(block_cache_trace_file, "", "Block cache trace file path.");
 DEFINE_int32(trace_replay_threads, 1,
              "The number of threads to replay, must >=1.");
+DEFINE_bool(trace_replay_preserve_key_order, false,
+            "With trace_replay_threads > 1, replay the operations on each key "
+            "in trace order by assigning the traces to the threads by key.");
+DEFINE_string(trace_replay_key_prefix, "",
+              "Prepend this prefix to every key of the replayed traces, to "
+              "replay a trace on a different key space.");
 
 DEFINE_bool(io_uring_enabled, true,
             "If true, enable the use of IO uring if the platform supports it");
@@ -1488,6 +1510,11 @@ DEFINE_bool(compression_use_zstd_dict_trainer,
             "If true, use ZSTD_TrainDictionary() to create dictionary, else"
             "use ZSTD_FinalizeDictionary() to create dictionary");
 
+DEFINE_bool(compression_reuse_dict_across_files,
+            ROCKSDB_NAMESPACE::CompressionOptions().reuse_dict_across_files,
+            "If true, the output files of a compaction reuse the dictionary "
+            "built for the first output file of the same level");
+
 static bool ValidateTableCacheNumshardbits(const char* flagname,
                                            int32_t value) {
   if (0 >= value || value >= 20) {
@@ -1847,6 +1874,17 @@ DEFINE_uint64(stats_persist_period_sec,
 DEFINE_bool(persist_stats_to_disk,
             ROCKSDB_NAMESPACE::Options().persist_stats_to_disk,
             "whether to persist stats to disk");
+DEFINE_bool(enable_cf_latency_stats,
+            ROCKSDB_NAMESPACE::Options().enable_cf_latency_stats,
+            "Keep per column family operation latency histograms");
+DEFINE_uint32(perf_context_sample_rate,
+              ROCKSDB_NAMESPACE::Options().perf_context_sample_rate,
+              "Sample 1 in this many read operations of each thread with "
+              "PerfContext timers enabled. 0 disables sampling");
+DEFINE_uint64(slow_operation_threshold_micros,
+              ROCKSDB_NAMESPACE::Options().slow_operation_threshold_micros,
+              "Log the operations that take at least this many microseconds "
+              "with their PerfContext counters. 0 disables it");
 DEFINE_uint64(stats_history_buffer_size,
               ROCKSDB_NAMESPACE::Options().stats_history_buffer_size,
               "Max number of stats snapshots to keep in memory");
@@ -4456,6 +4494,10 @@ class Benchmark {
     options.stats_persist_period_sec =
         static_cast<unsigned int>(FLAGS_stats_persist_period_sec);
     options.persist_stats_to_disk = FLAGS_persist_stats_to_disk;
+    options.enable_cf_latency_stats = FLAGS_enable_cf_latency_stats;
+    options.perf_context_sample_rate = FLAGS_perf_context_sample_rate;
+    options.slow_operation_threshold_micros =
+        FLAGS_slow_operation_threshold_micros;
     options.stats_history_buffer_size =
         static_cast<size_t>(FLAGS_stats_history_buffer_size);
     options.avoid_flush_during_recovery = FLAGS_avoid_flush_during_recovery;
@@ -4471,6 +4513,8 @@ class Benchmark {
         FLAGS_compression_max_dict_buffer_bytes;
     options.compression_opts.use_zstd_dict_trainer =
         FLAGS_compression_use_zstd_dict_trainer;
+    options.compression_opts.reuse_dict_across_files =
+        FLAGS_compression_reuse_dict_across_files;
 
     options.max_open_files = FLAGS_open_files;
     options.arena_block_size = FLAGS_arena_block_size;
@@ -4495,6 +4539,8 @@ class Benchmark {
         FLAGS_use_direct_io_for_flush_and_compaction;
     options.manual_wal_flush = FLAGS_manual_wal_flush;
     options.wal_compression = FLAGS_wal_compression_e;
+    options.wal_compression_threads = FLAGS_wal_compression_threads;
+    options.enable_pipelined_wal_recovery = FLAGS_enable_pipelined_wal_recovery;
     options.refresh_options_sec = FLAGS_refresh_options_sec;
     options.refresh_options_file = FLAGS_refresh_options_file;
     options.ttl = FLAGS_fifo_compaction_ttl;
@@ -4985,6 +5031,8 @@ class Benchmark {
         FLAGS_blob_garbage_collection_age_cutoff;
     options.blob_garbage_collection_force_threshold =
         FLAGS_blob_garbage_collection_force_threshold;
+    options.blob_garbage_collection_force_max_batches =
+        FLAGS_blob_garbage_collection_force_max_batches;
     options.blob_compaction_readahead_size =
         FLAGS_blob_compaction_readahead_size;
     options.blob_file_starting_level = FLAGS_blob_file_starting_level;
@@ -9188,14 +9236,51 @@ class Benchmark {
       fprintf(stderr, "Prepare for replay failed. Error: %s\n",
               s.ToString().c_str());
     }
+    ReplayOptions replay_options(
+        static_cast<uint32_t>(FLAGS_trace_replay_threads),
+        FLAGS_trace_replay_fast_forward, FLAGS_trace_replay_preserve_key_order);
+    if (!FLAGS_trace_replay_key_prefix.empty()) {
+      replay_options.key_remapper = [](const Slice& key) {
+        return FLAGS_trace_replay_key_prefix + key.ToString();
+      };
+    }
+    // Latency histograms (micros) of the replayed operations by trace type
+    std::map<TraceType, HistogramImpl> latencies;
+    for (TraceType type : {kTraceWrite, kTraceGet, kTraceIteratorSeek,
+                           kTraceIteratorSeekForPrev, kTraceMultiGet}) {
+      latencies[type];
+    }
     s = replayer->Replay(
-        ReplayOptions(static_cast<uint32_t>(FLAGS_trace_replay_threads),
-                      FLAGS_trace_replay_fast_forward),
-        nullptr);
+        replay_options,
+        [&latencies](Status /*exec_s*/,
+                     std::unique_ptr<TraceRecordResult>&& result) {
+          // The default replayer reports TraceExecutionResults
+          if (result != nullptr) {
+            auto* exec_result =
+                static_cast_with_check<TraceExecutionResult>(result.get());
+            auto it = latencies.find(exec_result->GetTraceType());
+            if (it != latencies.end()) {
+              it->second.Add(exec_result->GetLatency());
+            }
+          }
+        });
     replayer.reset();
     if (s.ok()) {
       fprintf(stdout, "Replay completed from trace_file: %s\n",
               FLAGS_trace_file.c_str());
+      const std::map<TraceType, const char*> type_names = {
+          {kTraceWrite, "Write"},
+          {kTraceGet, "Get"},
+          {kTraceIteratorSeek, "Seek"},
+          {kTraceIteratorSeekForPrev, "SeekForPrev"},
+          {kTraceMultiGet, "MultiGet"}};
+      for (const auto& latency : latencies) {
+        if (latency.second.num() > 0) {
+          fprintf(stdout, "%s latency (micros):\n%s\n",
+                  type_names.at(latency.first),
+                  latency.second.ToString().c_str());
+        }
+      }
     } else {
       fprintf(stderr, "Replay failed. Error: %s\n", s.ToString().c_str());
     }
@@ -21,9 +21,10 @@ namespace ROCKSDB_NAMESPACE {
 // - std::priority_queue does not have a replace-top operation, requiring a
 //   pop+push.  If the replacement element is the new top, this requires
 //   around 2logN comparisons.
-// - This heap's pop() uses a "schoolbook" downheap which requires up to ~2logN
-//   comparisons.
-// - This heap provides a replace_top() operation which requires [1, 2logN]
+// - This heap's pop() uses a "bottom-up" downheap which requires about logN
+//   comparisons plus the few needed to sift the element back up from the
+//   bottom level.
+// - This heap provides a replace_top() operation which requires [1, ~logN]
 //   comparisons.  When the replacement element is also the new top, this
 //   takes just 1 or 2 comparisons.
 //
@@ -126,42 +127,67 @@ class BinaryHeap {
     reset_root_cmp_cache();
   }
 
+  // Returns the child of `index` that must move up if the value at `index`
+  // sinks, or size() if `index` is a leaf.
+  size_t pick_child(size_t index) const {
+    const size_t left_child = get_left(index);
+    if (left_child >= data_.size()) {
+      return data_.size();
+    }
+    if (index == 0 && root_cmp_cache_ < data_.size()) {
+      return root_cmp_cache_;
+    }
+    const size_t right_child = left_child + 1;
+    assert(right_child == get_right(index));
+    if (right_child < data_.size() &&
+        cmp_(data_[left_child], data_[right_child])) {
+      return right_child;
+    }
+    return left_child;
+  }
+
   void downheap(size_t index) {
     T v = std::move(data_[index]);
 
-    size_t picked_child = std::numeric_limits<size_t>::max();
-    while (1) {
-      const size_t left_child = get_left(index);
-      if (get_left(index) >= data_.size()) {
-        break;
-      }
-      const size_t right_child = left_child + 1;
-      assert(right_child == get_right(index));
-      picked_child = left_child;
-      if (index == 0 && root_cmp_cache_ < data_.size()) {
-        picked_child = root_cmp_cache_;
-      } else if (right_child < data_.size() &&
-                 cmp_(data_[left_child], data_[right_child])) {
-        picked_child = right_child;
-      }
-      if (!cmp_(v, data_[picked_child])) {
-        break;
+    size_t picked_child = pick_child(index);
+    if (picked_child >= data_.size() || !cmp_(v, data_[picked_child])) {
+      if (index == 0) {
+        // We did not change anything in the tree except for the value
+        // of the root node, left and right child did not change, we can
+        // cache that `picked_child` is the smallest child
+        // so next time we compare againist it directly
+        root_cmp_cache_ = picked_child;
+      } else {
+        reset_root_cmp_cache();
       }
+      data_[index] = std::move(v);
+      return;
+    }
+
+    // `v` sinks. Rather than comparing it against the picked child on every
+    // level, move the hole all the way down to a leaf with a single
+    // comparison per level and then sift `v` back up from there. A value
+    // that sinks usually ends up close to the bottom, so this takes about
+    // logN comparisons instead of 2logN.
+    const size_t start = index;
+    do {
       data_[index] = std::move(data_[picked_child]);
       index = picked_child;
-    }
+      picked_child = pick_child(index);
+    } while (picked_child < data_.size());
 
-    if (index == 0) {
-      // We did not change anything in the tree except for the value
-      // of the root node, left and right child did not change, we can
-      // cache that `picked_child` is the smallest child
-      // so next time we compare againist it directly
-      root_cmp_cache_ = picked_child;
-    } else {
-      // the tree changed, reset cache
-      reset_root_cmp_cache();
+    while (index > start) {
+      const size_t parent = get_parent(index);
+      // The value moved into `start` is known to be greater than `v`.
+      if (parent == start || !cmp_(data_[parent], v)) {
+        break;
+      }
+      data_[index] = std::move(data_[parent]);
+      index = parent;
     }
 
+    // the tree changed, reset cache
+    reset_root_cmp_cache();
     data_[index] = std::move(v);
   }
 
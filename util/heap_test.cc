@@ -101,6 +101,47 @@ TEST_P(HeapTest, Test) {
   ASSERT_TRUE(heap.empty());
 }
 
+// Counts the comparisons made by replace_top() when merging many sorted runs
+// whose values interleave: every new value from the run on top usually sinks
+// deep into the heap.
+TEST(HeapComparisonsTest, MergeInterleavedRuns) {
+  constexpr size_t kNumRuns = 64;
+  constexpr int kIters = 10000;
+
+  size_t num_cmps = 0;
+  // Min-heap, as used by MergingIterator
+  auto cmp = [&num_cmps](HeapTestValue a, HeapTestValue b) {
+    ++num_cmps;
+    return a > b;
+  };
+  BinaryHeap<HeapTestValue, decltype(cmp)> heap(cmp);
+  std::priority_queue<HeapTestValue, std::vector<HeapTestValue>,
+                      std::greater<HeapTestValue>>
+      ref;
+
+  std::mt19937 rng(0x2f9d3e8b);
+  std::uniform_int_distribution<HeapTestValue> step_dist(1, 1000000);
+  for (size_t i = 0; i < kNumRuns; ++i) {
+    HeapTestValue val = step_dist(rng);
+    heap.push(val);
+    ref.push(val);
+  }
+
+  num_cmps = 0;
+  for (int i = 0; i < kIters; ++i) {
+    // Advance the run on top to its next value
+    HeapTestValue val = heap.top() + step_dist(rng);
+    heap.replace_top(val);
+    ref.pop();
+    ref.push(val);
+    ASSERT_EQ(ref.top(), heap.top());
+  }
+
+  // A schoolbook downheap needs about 9.6 comparisons per replace_top() here,
+  // the bottom-up downheap about 7.4.
+  ASSERT_LT(num_cmps, 8 * kIters);
+}
+
 // Basic test, MAX_VALUE = 3*MAX_HEAP_SIZE (occasional duplicates)
 INSTANTIATE_TEST_CASE_P(Basic, HeapTest,
                         ::testing::Values(Params(1000, 3000,
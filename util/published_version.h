@@ -0,0 +1,123 @@
+// Copyright (C) 2023 Speedb Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <mutex>
+
+#include "util/autovector.h"
+#include "util/thread_local.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// An immutable value that a writer replaces as a whole and many threads read
+// without locks, like the SuperVersion of a column family.
+//
+// Every reading thread keeps a reference to the version it last read in
+// thread local storage. A read marks the thread local reference as in use
+// and back, which only touches the cache line of the thread, so readers do
+// not contend with each other. Publish() replaces the current version and
+// scrapes the thread local references. The next read of each thread then
+// takes mutex_ once to get a reference to the new version. A version is
+// freed when the last thread that read it is done with it.
+template <class T>
+class PublishedVersion {
+ public:
+  PublishedVersion()
+      : current_(std::make_shared<const T>()),
+        local_(new ThreadLocalPtr(&UnrefLocalVersion)) {}
+
+  PublishedVersion(const PublishedVersion&) = delete;
+  PublishedVersion& operator=(const PublishedVersion&) = delete;
+
+  // Makes value the current version. A read that starts after Publish()
+  // returns reads value. The writers must be serialized by the caller.
+  void Publish(T value) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      current_ = std::make_shared<const T>(std::move(value));
+    }
+    autovector<void*> local_versions;
+    local_->Scrape(&local_versions, nullptr);
+    for (void* ptr : local_versions) {
+      if (ptr != InUse()) {
+        delete static_cast<LocalVersion*>(ptr);
+      }
+    }
+  }
+
+  // Pins the current version for the lifetime of the guard. A thread must
+  // not hold two guards of the same PublishedVersion at once.
+  class ReadGuard {
+   public:
+    explicit ReadGuard(const PublishedVersion* published)
+        : published_(published), local_version_(published->Acquire()) {}
+
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
+
+    ~ReadGuard() { published_->Release(local_version_); }
+
+    const T& operator*() const { return **local_version_; }
+    const T* operator->() const { return local_version_->get(); }
+
+   private:
+    const PublishedVersion* published_;
+    std::shared_ptr<const T>* local_version_;
+  };
+
+ private:
+  using LocalVersion = std::shared_ptr<const T>;
+
+  // Marks the thread local reference of a thread that is reading it
+  static void* InUse() {
+    static char in_use;
+    return &in_use;
+  }
+
+  // Called when a thread exits or local_ is destroyed, never during a read
+  static void UnrefLocalVersion(void* ptr) {
+    assert(ptr != InUse());
+    delete static_cast<LocalVersion*>(ptr);
+  }
+
+  LocalVersion* Acquire() const {
+    void* ptr = local_->Swap(InUse());
+    assert(ptr != InUse());
+    if (ptr == nullptr) {
+      // First read of the thread since the last Publish()
+      std::lock_guard<std::mutex> lock(mutex_);
+      return new LocalVersion(current_);
+    }
+    return static_cast<LocalVersion*>(ptr);
+  }
+
+  void Release(LocalVersion* local_version) const {
+    void* expected = InUse();
+    if (!local_->CompareAndSwap(local_version, expected)) {
+      // Scraped by a Publish() during the read, the version is obsolete
+      assert(expected == nullptr);
+      delete local_version;
+    }
+  }
+
+  // Protects current_ against the readers that refresh their reference
+  mutable std::mutex mutex_;
+  std::shared_ptr<const T> current_;
+  std::unique_ptr<ThreadLocalPtr> local_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
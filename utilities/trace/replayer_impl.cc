@@ -9,13 +9,190 @@
 #include <cmath>
 #include <thread>
 
+#include "db/write_batch_internal.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/system_clock.h"
+#include "rocksdb/write_batch.h"
+#include "util/hash.h"
 #include "util/threadpool_imp.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+// Copies a write batch, remapping its keys
+class KeyRemappingHandler : public WriteBatch::Handler {
+ public:
+  KeyRemappingHandler(const std::function<std::string(const Slice&)>& remapper,
+                      WriteBatch* batch)
+      : remapper_(remapper), batch_(batch) {}
+
+  Status PutCF(uint32_t column_family_id, const Slice& key,
+               const Slice& value) override {
+    return WriteBatchInternal::Put(batch_, column_family_id, remapper_(key),
+                                   value);
+  }
+
+  Status DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return WriteBatchInternal::Delete(batch_, column_family_id,
+                                      remapper_(key));
+  }
+
+  Status SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return WriteBatchInternal::SingleDelete(batch_, column_family_id,
+                                            remapper_(key));
+  }
+
+  Status DeleteRangeCF(uint32_t column_family_id, const Slice& begin_key,
+                       const Slice& end_key) override {
+    return WriteBatchInternal::DeleteRange(
+        batch_, column_family_id, remapper_(begin_key), remapper_(end_key));
+  }
+
+  Status MergeCF(uint32_t column_family_id, const Slice& key,
+                 const Slice& value) override {
+    return WriteBatchInternal::Merge(batch_, column_family_id, remapper_(key),
+                                     value);
+  }
+
+  void LogData(const Slice& blob) override {
+    batch_->PutLogData(blob).PermitUncheckedError();
+  }
+
+ private:
+  const std::function<std::string(const Slice&)>& remapper_;
+  WriteBatch* batch_;
+};
+
+// Finds the first key of a write batch
+class FirstKeyHandler : public WriteBatch::Handler {
+ public:
+  explicit FirstKeyHandler(std::string* key) : key_(key) {}
+
+  Status PutCF(uint32_t, const Slice& key, const Slice&) override {
+    return SetKey(key);
+  }
+  Status PutEntityCF(uint32_t, const Slice& key, const Slice&) override {
+    return SetKey(key);
+  }
+  Status DeleteCF(uint32_t, const Slice& key) override { return SetKey(key); }
+  Status SingleDeleteCF(uint32_t, const Slice& key) override {
+    return SetKey(key);
+  }
+  Status DeleteRangeCF(uint32_t, const Slice& begin_key,
+                       const Slice&) override {
+    return SetKey(begin_key);
+  }
+  Status MergeCF(uint32_t, const Slice& key, const Slice&) override {
+    return SetKey(key);
+  }
+  Status PutBlobIndexCF(uint32_t, const Slice& key, const Slice&) override {
+    return SetKey(key);
+  }
+  Status MarkBeginPrepare(bool) override { return Status::OK(); }
+  Status MarkEndPrepare(const Slice&) override { return Status::OK(); }
+  Status MarkCommit(const Slice&) override { return Status::OK(); }
+  Status MarkCommitWithTimestamp(const Slice&, const Slice&) override {
+    return Status::OK();
+  }
+  Status MarkRollback(const Slice&) override { return Status::OK(); }
+  Status MarkNoop(bool) override { return Status::OK(); }
+
+  bool Continue() override { return !found_; }
+
+ private:
+  Status SetKey(const Slice& key) {
+    key_->assign(key.data(), key.size());
+    found_ = true;
+    return Status::OK();
+  }
+
+  std::string* key_;
+  bool found_ = false;
+};
+
+// Replaces the keys of a decoded trace with the keys returned by remapper
+Status RemapTraceRecordKeys(
+    const std::function<std::string(const Slice&)>& remapper,
+    std::unique_ptr<TraceRecord>* record) {
+  TraceRecord* old_record = record->get();
+  const uint64_t ts = old_record->GetTimestamp();
+  switch (old_record->GetTraceType()) {
+    case kTraceGet: {
+      auto* get = static_cast<GetQueryTraceRecord*>(old_record);
+      record->reset(new GetQueryTraceRecord(get->GetColumnFamilyID(),
+                                            remapper(get->GetKey()), ts));
+      return Status::OK();
+    }
+    case kTraceIteratorSeek:
+    case kTraceIteratorSeekForPrev: {
+      auto* seek = static_cast<IteratorSeekQueryTraceRecord*>(old_record);
+      const Slice lower_bound = seek->GetLowerBound();
+      const Slice upper_bound = seek->GetUpperBound();
+      record->reset(new IteratorSeekQueryTraceRecord(
+          seek->GetSeekType(), seek->GetColumnFamilyID(),
+          remapper(seek->GetKey()),
+          lower_bound.empty() ? std::string() : remapper(lower_bound),
+          upper_bound.empty() ? std::string() : remapper(upper_bound), ts));
+      return Status::OK();
+    }
+    case kTraceMultiGet: {
+      auto* multi_get = static_cast<MultiGetQueryTraceRecord*>(old_record);
+      std::vector<std::string> keys;
+      for (const Slice& key : multi_get->GetKeys()) {
+        keys.push_back(remapper(key));
+      }
+      record->reset(new MultiGetQueryTraceRecord(
+          multi_get->GetColumnFamilyIDs(), keys, ts));
+      return Status::OK();
+    }
+    case kTraceWrite: {
+      auto* write = static_cast<WriteQueryTraceRecord*>(old_record);
+      WriteBatch old_batch(write->GetWriteBatchRep().ToString());
+      WriteBatch new_batch;
+      KeyRemappingHandler handler(remapper, &new_batch);
+      Status s = old_batch.Iterate(&handler);
+      if (!s.ok()) {
+        return s;
+      }
+      record->reset(new WriteQueryTraceRecord(new_batch.Data(), ts));
+      return Status::OK();
+    }
+    default:
+      return Status::NotSupported("Unsupported trace type.");
+  }
+}
+
+// Hash of the key (or first key) of a decoded trace
+uint32_t TraceRecordKeyHash(const TraceRecord& record) {
+  switch (record.GetTraceType()) {
+    case kTraceGet:
+      return GetSliceHash(
+          static_cast<const GetQueryTraceRecord&>(record).GetKey());
+    case kTraceIteratorSeek:
+    case kTraceIteratorSeekForPrev:
+      return GetSliceHash(
+          static_cast<const IteratorSeekQueryTraceRecord&>(record).GetKey());
+    case kTraceMultiGet: {
+      const auto keys =
+          static_cast<const MultiGetQueryTraceRecord&>(record).GetKeys();
+      return keys.empty() ? 0 : GetSliceHash(keys.front());
+    }
+    case kTraceWrite: {
+      WriteBatch batch(static_cast<const WriteQueryTraceRecord&>(record)
+                           .GetWriteBatchRep()
+                           .ToString());
+      std::string key;
+      FirstKeyHandler handler(&key);
+      batch.Iterate(&handler).PermitUncheckedError();
+      return GetSliceHash(key);
+    }
+    default:
+      return 0;
+  }
+}
+}  // namespace
+
 ReplayerImpl::ReplayerImpl(DB* db,
                            const std::vector<ColumnFamilyHandle*>& handles,
                            std::unique_ptr<TraceReader>&& reader)
@@ -117,6 +294,9 @@ Status ReplayerImpl::Replay(
       // In single-threaded replay, decode first then sleep.
       std::unique_ptr<TraceRecord> record;
       s = TracerHelper::DecodeTraceRecord(&trace, trace_file_version_, &record);
+      if (s.ok() && options.key_remapper) {
+        s = RemapTraceRecordKeys(options.key_remapper, &record);
+      }
       if (!s.ok() && !s.IsNotSupported()) {
         break;
       }
@@ -147,10 +327,22 @@ Status ReplayerImpl::Replay(
       }
     }
   } else {
-    // Multi-threaded replay.
-    ThreadPoolImpl thread_pool;
-    thread_pool.SetHostEnv(env_);
-    thread_pool.SetBackgroundThreads(static_cast<int>(options.num_threads));
+    // Multi-threaded replay. To preserve the order of the traces on each
+    // key, each thread has its own pool, which executes the traces scheduled
+    // on it in order.
+    const uint32_t num_pools =
+        options.preserve_key_order ? options.num_threads : 1;
+    std::vector<std::unique_ptr<ThreadPoolImpl>> thread_pools(num_pools);
+    for (auto& thread_pool : thread_pools) {
+      thread_pool.reset(new ThreadPoolImpl());
+      thread_pool->SetHostEnv(env_);
+      thread_pool->SetBackgroundThreads(
+          static_cast<int>(options.num_threads / num_pools));
+    }
+    // The traces are decoded before they are scheduled when their keys are
+    // needed, and by the thread executing them otherwise
+    const bool decode_before_schedule =
+        options.preserve_key_order || options.key_remapper != nullptr;
 
     std::mutex mtx;
     // Background decoding and execution status.
@@ -215,13 +407,30 @@ Status ReplayerImpl::Replay(
           trace_type == kTraceIteratorSeekForPrev ||
           trace_type == kTraceMultiGet) {
         std::unique_ptr<ReplayerWorkerArg> ra(new ReplayerWorkerArg);
+        size_t pool_idx = 0;
+        if (decode_before_schedule) {
+          Status decode_s = TracerHelper::DecodeTraceRecord(
+              &trace, trace_file_version_, &ra->record);
+          if (decode_s.ok() && options.key_remapper) {
+            decode_s = RemapTraceRecordKeys(options.key_remapper, &ra->record);
+          }
+          if (!decode_s.ok()) {
+            // Stop the replay, as BackgroundWork() would
+            error_cb(decode_s, trace.ts);
+            if (result_callback != nullptr) {
+              result_callback(decode_s, nullptr);
+            }
+            continue;
+          }
+          pool_idx = TraceRecordKeyHash(*ra->record) % num_pools;
+        }
         ra->trace_entry = std::move(trace);
         ra->handler = exec_handler_.get();
         ra->trace_file_version = trace_file_version_;
         ra->error_cb = error_cb;
         ra->result_cb = result_callback;
-        thread_pool.Schedule(&ReplayerImpl::BackgroundWork, ra.release(),
-                             nullptr, nullptr);
+        thread_pools[pool_idx]->Schedule(&ReplayerImpl::BackgroundWork,
+                                         ra.release(), nullptr, nullptr);
       } else {
         // Skip unsupported traces.
         if (result_callback != nullptr) {
@@ -231,7 +440,9 @@ Status ReplayerImpl::Replay(
       }
     }
 
-    thread_pool.WaitForJobsAndJoinAllThreads();
+    for (auto& thread_pool : thread_pools) {
+      thread_pool->WaitForJobsAndJoinAllThreads();
+    }
     if (!bg_s.ok()) {
       s = bg_s;
     }
@@ -286,9 +497,12 @@ void ReplayerImpl::BackgroundWork(void* arg) {
       reinterpret_cast<ReplayerWorkerArg*>(arg));
   assert(ra != nullptr);
 
-  std::unique_ptr<TraceRecord> record;
-  Status s = TracerHelper::DecodeTraceRecord(&(ra->trace_entry),
-                                             ra->trace_file_version, &record);
+  std::unique_ptr<TraceRecord> record = std::move(ra->record);
+  Status s;
+  if (record == nullptr) {
+    s = TracerHelper::DecodeTraceRecord(&(ra->trace_entry),
+                                        ra->trace_file_version, &record);
+  }
   if (!s.ok()) {
     // Stop the replay
     if (ra->error_cb != nullptr) {
@@ -70,6 +70,8 @@ class ReplayerImpl : public Replayer {
 // Arguments passed to BackgroundWork() for replaying in a thread pool.
 struct ReplayerWorkerArg {
   Trace trace_entry;
+  // The trace, if it was already decoded
+  std::unique_ptr<TraceRecord> record;
   int trace_file_version;
   // Handler to execute TraceRecord.
   TraceRecord::Handler* handler;
@@ -10,6 +10,23 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+Status LockManager::TryLockKeys(PessimisticTransaction* txn,
+                                ColumnFamilyId column_family_id,
+                                const std::vector<std::string>& keys,
+                                Env* env, bool exclusive) {
+  // Lock the keys one by one in the order the caller sorted them
+  for (size_t i = 0; i < keys.size(); i++) {
+    Status s = TryLock(txn, column_family_id, keys[i], env, exclusive);
+    if (!s.ok()) {
+      for (size_t j = 0; j < i; j++) {
+        UnLock(txn, column_family_id, keys[j], env);
+      }
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
 std::shared_ptr<LockManager> NewLockManager(PessimisticTransactionDB* db,
                                             const TransactionDBOptions& opt) {
   assert(db);
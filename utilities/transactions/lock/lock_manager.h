@@ -47,6 +47,15 @@ class LockManager {
                          ColumnFamilyId column_family_id, const Endpoint& start,
                          const Endpoint& end, Env* env, bool exclusive) = 0;
 
+  // Attempt to lock all of `keys`, in an order that is the same for every
+  // caller, so that concurrent callers cannot deadlock on each other. Either
+  // all keys are locked and OK is returned, or none is locked.
+  // REQUIRES: txn does not already hold a lock on any of `keys`.
+  virtual Status TryLockKeys(PessimisticTransaction* txn,
+                             ColumnFamilyId column_family_id,
+                             const std::vector<std::string>& keys, Env* env,
+                             bool exclusive);
+
   // Unlock a key or a range locked by TryLock().  txn must be the same
   // Transaction that locked this key.
   virtual void UnLock(PessimisticTransaction* txn, const LockTracker& tracker,
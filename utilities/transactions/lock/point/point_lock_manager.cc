@@ -45,23 +45,78 @@ struct LockInfo {
   DECLARE_DEFAULT_MOVES(LockInfo);
 };
 
+// A transaction waiting for a key lock. Each waiter has its own condition
+// variable, so releasing a key only wakes the waiters of that key.
+struct KeyLockWaiter {
+  explicit KeyLockWaiter(std::shared_ptr<TransactionDBCondVar> _cv)
+      : cv(std::move(_cv)) {
+    assert(cv);
+  }
+
+  std::shared_ptr<TransactionDBCondVar> cv;
+};
+
 struct LockMapStripe {
-  explicit LockMapStripe(std::shared_ptr<TransactionDBMutexFactory> factory) {
+  explicit LockMapStripe(std::shared_ptr<TransactionDBMutexFactory> factory)
+      : mutex_factory(factory) {
     stripe_mutex = factory->AllocateMutex();
-    stripe_cv = factory->AllocateCondVar();
     assert(stripe_mutex);
-    assert(stripe_cv);
   }
 
   // Mutex must be held before modifying keys map
   std::shared_ptr<TransactionDBMutex> stripe_mutex;
 
-  // Condition Variable per stripe for waiting on a lock
-  std::shared_ptr<TransactionDBCondVar> stripe_cv;
+  // Allocates the condition variables of the waiters
+  std::shared_ptr<TransactionDBMutexFactory> mutex_factory;
 
   // Locked keys mapped to the info about the transactions that locked them.
   // TODO(agiardullo): Explore performance of other data structures.
   UnorderedMap<std::string, LockInfo> keys;
+
+  // Waiters of each contended key. Releasing a key wakes all the waiters of
+  // that key, but none of the other keys of the stripe. Every woken waiter
+  // retries the lock, and the ones that still cannot take it run deadlock
+  // detection again against the current holders of the key.
+  UnorderedMap<std::string, std::vector<KeyLockWaiter*>> waiters;
+
+  // REQUIRED: stripe_mutex must be held.
+  void AddWaiter(const std::string& key, KeyLockWaiter* waiter) {
+    waiters[key].push_back(waiter);
+  }
+
+  // REQUIRED: stripe_mutex must be held.
+  void RemoveWaiter(const std::string& key, KeyLockWaiter* waiter) {
+    auto it = waiters.find(key);
+    assert(it != waiters.end());
+    auto& key_waiters = it->second;
+    auto pos = std::find(key_waiters.begin(), key_waiters.end(), waiter);
+    assert(pos != key_waiters.end());
+    key_waiters.erase(pos);
+    if (key_waiters.empty()) {
+      waiters.erase(it);
+    }
+  }
+
+  // Wakes the waiters of `key`, if any.
+  // REQUIRED: stripe_mutex must be held.
+  void NotifyWaiters(const std::string& key) {
+    auto it = waiters.find(key);
+    if (it != waiters.end()) {
+      for (KeyLockWaiter* waiter : it->second) {
+        waiter->cv->Notify();
+      }
+    }
+  }
+
+  // Wakes the waiters of every key.
+  // REQUIRED: stripe_mutex must be held.
+  void NotifyAllWaiters() {
+    for (auto& it : waiters) {
+      for (KeyLockWaiter* waiter : it.second) {
+        waiter->cv->Notify();
+      }
+    }
+  }
 };
 
 // Map of #num_stripes LockMapStripes
@@ -249,6 +304,104 @@ Status PointLockManager::TryLock(PessimisticTransaction* txn,
                             timeout, lock_info);
 }
 
+Status PointLockManager::TryLockKeys(PessimisticTransaction* txn,
+                                     ColumnFamilyId column_family_id,
+                                     const std::vector<std::string>& keys,
+                                     Env* env, bool exclusive) {
+  std::shared_ptr<LockMap> lock_map_ptr = GetLockMap(column_family_id);
+  LockMap* lock_map = lock_map_ptr.get();
+  if (lock_map == nullptr) {
+    char msg[255];
+    snprintf(msg, sizeof(msg), "Column family id not found: %" PRIu32,
+             column_family_id);
+
+    return Status::InvalidArgument(msg);
+  }
+
+  // Every caller locks in the same (stripe, key) order, and only waits for
+  // the next key in that order, so batches cannot deadlock each other.
+  std::vector<std::pair<size_t, const std::string*>> sorted_keys;
+  sorted_keys.reserve(keys.size());
+  for (const std::string& key : keys) {
+    sorted_keys.emplace_back(lock_map->GetStripe(key), &key);
+  }
+  std::sort(sorted_keys.begin(), sorted_keys.end(),
+            [](const std::pair<size_t, const std::string*>& a,
+               const std::pair<size_t, const std::string*>& b) {
+              return a.first != b.first ? a.first < b.first
+                                        : *a.second < *b.second;
+            });
+  sorted_keys.erase(
+      std::unique(sorted_keys.begin(), sorted_keys.end(),
+                  [](const std::pair<size_t, const std::string*>& a,
+                     const std::pair<size_t, const std::string*>& b) {
+                    return *a.second == *b.second;
+                  }),
+      sorted_keys.end());
+
+  LockInfo lock_info(txn->GetID(), txn->GetExpirationTime(), exclusive);
+  int64_t timeout = txn->GetLockTimeout();
+
+  Status s;
+  size_t num_locked = 0;
+  while (num_locked < sorted_keys.size()) {
+    const size_t stripe_num = sorted_keys[num_locked].first;
+    LockMapStripe* stripe = lock_map->lock_map_stripes_.at(stripe_num);
+
+    if (timeout < 0) {
+      s = stripe->stripe_mutex->Lock();
+    } else {
+      s = stripe->stripe_mutex->TryLockFor(timeout);
+    }
+    if (!s.ok()) {
+      break;
+    }
+    uint64_t expire_time_hint = 0;
+    autovector<TransactionID> wait_ids;
+    Status acquired;
+    while (num_locked < sorted_keys.size() &&
+           sorted_keys[num_locked].first == stripe_num) {
+      acquired =
+          AcquireLocked(lock_map, stripe, *sorted_keys[num_locked].second, env,
+                        lock_info, &expire_time_hint, &wait_ids);
+      if (!acquired.ok()) {
+        break;
+      }
+      num_locked++;
+    }
+    stripe->stripe_mutex->UnLock();
+
+    if (!acquired.ok()) {
+      // Wait for this key the same way TryLock() does
+      s = AcquireWithTimeout(txn, lock_map, stripe, column_family_id,
+                             *sorted_keys[num_locked].second, env, timeout,
+                             lock_info);
+      if (!s.ok()) {
+        break;
+      }
+      num_locked++;
+    }
+  }
+
+  if (!s.ok()) {
+    // Release what this call has locked, one stripe at a time
+    size_t i = 0;
+    while (i < num_locked) {
+      const size_t stripe_num = sorted_keys[i].first;
+      LockMapStripe* stripe = lock_map->lock_map_stripes_.at(stripe_num);
+      stripe->stripe_mutex->Lock().PermitUncheckedError();
+      for (; i < num_locked && sorted_keys[i].first == stripe_num; i++) {
+        UnLockKey(txn, *sorted_keys[i].second, stripe, lock_map, env);
+      }
+      stripe->stripe_mutex->UnLock();
+    }
+    if (num_locked > 0 && max_num_locks_ > 0) {
+      NotifyLockLimitWaiters(lock_map);
+    }
+  }
+  return s;
+}
+
 // Helper function for TryLock().
 Status PointLockManager::AcquireWithTimeout(
     PessimisticTransaction* txn, LockMap* lock_map, LockMapStripe* stripe,
@@ -283,6 +436,8 @@ Status PointLockManager::AcquireWithTimeout(
   if (!result.ok() && timeout != 0) {
     PERF_TIMER_GUARD(key_lock_wait_time);
     PERF_COUNTER_ADD(key_lock_wait_count, 1);
+    KeyLockWaiter waiter(stripe->mutex_factory->AllocateCondVar());
+    stripe->AddWaiter(key, &waiter);
     // If we weren't able to acquire the lock, we will keep retrying as long
     // as the timeout allows.
     bool timed_out = false;
@@ -306,8 +461,7 @@ Status PointLockManager::AcquireWithTimeout(
           if (IncrementWaiters(txn, wait_ids, key, column_family_id,
                                lock_info.exclusive, env)) {
             result = Status::Busy(Status::SubCode::kDeadlock);
-            stripe->stripe_mutex->UnLock();
-            return result;
+            break;
           }
         }
         txn->SetWaitingTxn(wait_ids, column_family_id, &key);
@@ -316,12 +470,12 @@ Status PointLockManager::AcquireWithTimeout(
       TEST_SYNC_POINT("PointLockManager::AcquireWithTimeout:WaitingTxn");
       if (cv_end_time < 0) {
         // Wait indefinitely
-        result = stripe->stripe_cv->Wait(stripe->stripe_mutex);
+        result = waiter.cv->Wait(stripe->stripe_mutex);
       } else {
         uint64_t now = env->NowMicros();
         if (static_cast<uint64_t>(cv_end_time) > now) {
-          result = stripe->stripe_cv->WaitFor(stripe->stripe_mutex,
-                                              cv_end_time - now);
+          result =
+              waiter.cv->WaitFor(stripe->stripe_mutex, cv_end_time - now);
         }
       }
 
@@ -344,6 +498,8 @@ Status PointLockManager::AcquireWithTimeout(
                                &expire_time_hint, &wait_ids);
       }
     } while (!result.ok() && !timed_out);
+
+    stripe->RemoveWaiter(key, &waiter);
   }
 
   stripe->stripe_mutex->UnLock();
@@ -567,6 +723,11 @@ void PointLockManager::UnLockKey(PessimisticTransaction* txn,
         assert(lock_map->lock_cnt.load(std::memory_order_relaxed) > 0);
         lock_map->lock_cnt--;
       }
+
+      // Let the waiters of this key retry locking. With a lock limit, the
+      // caller also wakes the waiters of the other keys once it has released
+      // the stripe mutex.
+      stripe->NotifyWaiters(key);
     }
   } else {
     // This key is either not locked or locked by someone else.  This should
@@ -595,8 +756,20 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
   UnLockKey(txn, key, stripe, lock_map, env);
   stripe->stripe_mutex->UnLock();
 
-  // Signal waiting threads to retry locking
-  stripe->stripe_cv->NotifyAll();
+  if (max_num_locks_ > 0) {
+    NotifyLockLimitWaiters(lock_map);
+  }
+}
+
+void PointLockManager::NotifyLockLimitWaiters(LockMap* lock_map) {
+  // A waiter blocked by the lock limit may wait on any stripe. Only one
+  // stripe mutex is held at a time, so this cannot deadlock with a thread
+  // locking stripes in order.
+  for (LockMapStripe* stripe : lock_map->lock_map_stripes_) {
+    stripe->stripe_mutex->Lock().PermitUncheckedError();
+    stripe->NotifyAllWaiters();
+    stripe->stripe_mutex->UnLock();
+  }
 }
 
 void PointLockManager::UnLock(PessimisticTransaction* txn,
@@ -640,9 +813,10 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
       }
 
       stripe->stripe_mutex->UnLock();
+    }
 
-      // Signal waiting threads to retry locking
-      stripe->stripe_cv->NotifyAll();
+    if (max_num_locks_ > 0) {
+      NotifyLockLimitWaiters(lock_map);
     }
   }
 }
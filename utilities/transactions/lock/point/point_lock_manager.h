@@ -137,6 +137,12 @@ class PointLockManager : public LockManager {
   Status TryLock(PessimisticTransaction* txn, ColumnFamilyId column_family_id,
                  const Endpoint& start, const Endpoint& end, Env* env,
                  bool exclusive) override;
+  // Locks the keys in (stripe, key) order, taking each stripe mutex once for
+  // all of its keys that can be locked without waiting.
+  Status TryLockKeys(PessimisticTransaction* txn,
+                     ColumnFamilyId column_family_id,
+                     const std::vector<std::string>& keys, Env* env,
+                     bool exclusive) override;
 
   void UnLock(PessimisticTransaction* txn, const LockTracker& tracker,
               Env* env) override;
@@ -209,6 +215,10 @@ class PointLockManager : public LockManager {
   void UnLockKey(PessimisticTransaction* txn, const std::string& key,
                  LockMapStripe* stripe, LockMap* lock_map, Env* env);
 
+  // Wakes the waiters of every key of lock_map, for the waiters blocked
+  // by max_num_locks. REQUIRED: no stripe mutex of lock_map is held.
+  void NotifyLockLimitWaiters(LockMap* lock_map);
+
   bool IncrementWaiters(const PessimisticTransaction* txn,
                         const autovector<TransactionID>& wait_ids,
                         const std::string& key, const uint32_t& cf_id,
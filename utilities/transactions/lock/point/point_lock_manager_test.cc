@@ -157,6 +157,120 @@ TEST_F(PointLockManagerTest, DeadlockDepthExceeded) {
   delete txn1;
 }
 
+TEST_F(PointLockManagerTest, HotKeyContention) {
+  // Many threads take turns on a few keys of the same stripe, mixing shared
+  // and exclusive locks. Every waiter has to be woken by the release of the
+  // key it waits for.
+  TransactionDBOptions txn_db_opt;
+  txn_db_opt.num_stripes = 1;
+  auto locker = NewPointLockManager(txn_db_opt);
+  MockColumnFamilyHandle cf(1);
+  locker->AddColumnFamily(&cf);
+
+  const int kNumThreads = 8;
+  const int kNumKeys = 3;
+  const int kIterations = 200;
+  std::vector<int> counters(kNumKeys, 0);
+  TransactionOptions txn_opt;
+  txn_opt.lock_timeout = 10000000;
+
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      auto txn = NewTxn(txn_opt);
+      for (int i = 0; i < kIterations; i++) {
+        const int k = (t + i) % kNumKeys;
+        const std::string key = "k" + std::to_string(k);
+        const bool exclusive = (i % 4) != 0;
+        ASSERT_OK(locker->TryLock(txn, 1, key, env_, exclusive));
+        if (exclusive) {
+          // Not atomic on purpose, the lock must serialize the updates
+          counters[k]++;
+        }
+        locker->UnLock(txn, 1, key, env_);
+      }
+      delete txn;
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  int total = 0;
+  for (int c : counters) {
+    total += c;
+  }
+  ASSERT_EQ(total, kNumThreads * kIterations * 3 / 4);
+}
+
+TEST_F(PointLockManagerTest, WaitForLockLimit) {
+  // A transaction blocked by the lock limit is woken when a lock on another
+  // key is released, whether or not the two keys share a stripe.
+  for (size_t num_stripes : {1, 16}) {
+    TransactionDBOptions txn_db_opt;
+    txn_db_opt.max_num_locks = 1;
+    txn_db_opt.num_stripes = num_stripes;
+    auto locker = NewPointLockManager(txn_db_opt);
+    MockColumnFamilyHandle cf(1);
+    locker->AddColumnFamily(&cf);
+
+    TransactionOptions txn_opt;
+    txn_opt.lock_timeout = 10000000;
+    auto txn1 = NewTxn(txn_opt);
+    auto txn2 = NewTxn(txn_opt);
+    ASSERT_OK(locker->TryLock(txn1, 1, "k1", env_, true));
+
+    port::Thread t = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+      // block because txn1 holds the only lock allowed
+      ASSERT_OK(locker->TryLock(txn2, 1, "k2", env_, true));
+    });
+    locker->UnLock(txn1, 1, "k1", env_);
+    t.join();
+
+    locker->UnLock(txn2, 1, "k2", env_);
+    delete txn2;
+    delete txn1;
+  }
+}
+
+TEST_F(PointLockManagerTest, UpgradeQueuedBehindExclusiveWaiter) {
+  // txn1 and txn2 share a lock, txn3 waits for it exclusively, then txn1
+  // waits to upgrade its shared lock. When txn2 releases, txn3 is woken
+  // first but still conflicts with txn1, so it must pass the wakeup on to
+  // txn1, which can now upgrade.
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  TransactionOptions txn_opt;
+  txn_opt.lock_timeout = 10000000;
+  auto txn1 = NewTxn(txn_opt);
+  auto txn2 = NewTxn(txn_opt);
+  auto txn3 = NewTxn(txn_opt);
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k", env_, false));
+  ASSERT_OK(locker_->TryLock(txn2, 1, "k", env_, false));
+
+  port::Thread t3 = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+    ASSERT_OK(locker_->TryLock(txn3, 1, "k", env_, true));
+  });
+  port::Thread t1 = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+    ASSERT_OK(locker_->TryLock(txn1, 1, "k", env_, true));
+  });
+
+  locker_->UnLock(txn2, 1, "k", env_);
+  t1.join();
+  auto s = locker_->GetPointLockStatus();
+  ASSERT_EQ(s.size(), 1u);
+  ASSERT_TRUE(s.begin()->second.exclusive);
+  ASSERT_EQ(s.begin()->second.ids.size(), 1u);
+  ASSERT_EQ(s.begin()->second.ids[0], txn1->GetID());
+
+  locker_->UnLock(txn1, 1, "k", env_);
+  t3.join();
+  locker_->UnLock(txn3, 1, "k", env_);
+  delete txn3;
+  delete txn2;
+  delete txn1;
+}
+
 INSTANTIATE_TEST_CASE_P(PointLockManager, AnyLockManagerTest,
                         ::testing::Values(nullptr));
 
@@ -72,6 +72,13 @@ class PointLockManagerTest : public testing::Test {
     return reinterpret_cast<PessimisticTransaction*>(txn);
   }
 
+  // Creates another lock manager for the test DB with the given options.
+  std::shared_ptr<LockManager> NewPointLockManager(
+      const TransactionDBOptions& txn_opt) {
+    return std::make_shared<PointLockManager>(
+        static_cast<PessimisticTransactionDB*>(db_), txn_opt);
+  }
+
  protected:
   Env* env_;
   std::shared_ptr<LockManager> locker_;
@@ -0,0 +1,142 @@
+// Copyright (C) 2023 Speedb Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utilities/transactions/optimistic_key_version_cache.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "rocksdb/write_batch.h"
+#include "util/fastrange.h"
+#include "util/hash.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+class SlotCollector : public WriteBatch::Handler {
+ public:
+  SlotCollector(std::function<size_t(uint32_t, const Slice&)> slot_index,
+                std::vector<size_t>* slots)
+      : slot_index_(std::move(slot_index)), slots_(slots) {}
+
+  Status PutCF(uint32_t column_family_id, const Slice& key,
+               const Slice& /*value*/) override {
+    return Add(column_family_id, key);
+  }
+  Status PutEntityCF(uint32_t column_family_id, const Slice& key,
+                     const Slice& /*entity*/) override {
+    return Add(column_family_id, key);
+  }
+  Status DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return Add(column_family_id, key);
+  }
+  Status SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return Add(column_family_id, key);
+  }
+  Status MergeCF(uint32_t column_family_id, const Slice& key,
+                 const Slice& /*value*/) override {
+    return Add(column_family_id, key);
+  }
+  Status MarkNoop(bool /*empty_batch*/) override { return Status::OK(); }
+
+ private:
+  Status Add(uint32_t column_family_id, const Slice& key) {
+    slots_->push_back(slot_index_(column_family_id, key));
+    return Status::OK();
+  }
+
+  std::function<size_t(uint32_t, const Slice&)> slot_index_;
+  std::vector<size_t>* slots_;
+};
+}  // namespace
+
+OptimisticKeyVersionCache::OptimisticKeyVersionCache(size_t num_slots,
+                                                     SequenceNumber start_seq)
+    : num_slots_(std::max<size_t>(num_slots, 1)),
+      slots_(new Slot[num_slots_]),
+      min_seq_(start_seq) {}
+
+size_t OptimisticKeyVersionCache::SlotIndex(uint32_t column_family_id,
+                                            const Slice& key) const {
+  return FastRange64(GetSliceNPHash64(key, column_family_id), num_slots_);
+}
+
+void OptimisticKeyVersionCache::UpdateMax(std::atomic<SequenceNumber>* value,
+                                          SequenceNumber seq) {
+  SequenceNumber current = value->load(std::memory_order_relaxed);
+  while (current < seq &&
+         !value->compare_exchange_weak(current, seq,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+void OptimisticKeyVersionCache::BeginWrite(const WriteBatch& batch,
+                                           PendingWrite* write) {
+  write->slots.clear();
+  write->untracked = false;
+  SlotCollector collector(
+      [this](uint32_t column_family_id, const Slice& key) {
+        return SlotIndex(column_family_id, key);
+      },
+      &write->slots);
+  if (!batch.Iterate(&collector).ok()) {
+    write->slots.clear();
+    write->untracked = true;
+    untracked_writers_.fetch_add(1);
+    return;
+  }
+  std::sort(write->slots.begin(), write->slots.end());
+  write->slots.erase(std::unique(write->slots.begin(), write->slots.end()),
+                     write->slots.end());
+  for (size_t slot : write->slots) {
+    slots_[slot].writers.fetch_add(1);
+  }
+}
+
+void OptimisticKeyVersionCache::EndWrite(const PendingWrite& write,
+                                         SequenceNumber seq) {
+  // The sequence number must be visible before the write stops being in
+  // progress.
+  if (write.untracked) {
+    UpdateMax(&min_seq_, seq);
+    untracked_writers_.fetch_sub(1, std::memory_order_release);
+    return;
+  }
+  for (size_t slot : write.slots) {
+    UpdateMax(&slots_[slot].seq, seq);
+    slots_[slot].writers.fetch_sub(1, std::memory_order_release);
+  }
+}
+
+bool OptimisticKeyVersionCache::NotWrittenAfter(
+    uint32_t column_family_id, const Slice& key, SequenceNumber seq,
+    const PendingWrite* own_write) const {
+  uint32_t untracked_writers = own_write && own_write->untracked ? 1 : 0;
+  if (untracked_writers_.load(std::memory_order_acquire) > untracked_writers ||
+      seq < min_seq_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  const size_t index = SlotIndex(column_family_id, key);
+  uint32_t writers = 0;
+  if (own_write && std::binary_search(own_write->slots.begin(),
+                                      own_write->slots.end(), index)) {
+    writers = 1;
+  }
+  const Slot& slot = slots_[index];
+  return slot.writers.load(std::memory_order_acquire) == writers &&
+         slot.seq.load(std::memory_order_relaxed) <= seq;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
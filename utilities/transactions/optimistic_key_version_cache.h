@@ -0,0 +1,87 @@
+// Copyright (C) 2023 Speedb Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/types.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class WriteBatch;
+
+// A fixed size table of the latest sequence numbers written to the keys of an
+// OptimisticTransactionDB, used to validate transactions without looking the
+// keys up in the memtables.
+//
+// Each (column family, key) hashes to a slot holding the largest sequence
+// number written to any key of the slot, and the number of writes to keys of
+// the slot that are in progress. Nothing is ever evicted: keys sharing a slot
+// only make the answer more conservative. A key is known not to have been
+// written after a sequence number if no write to its slot is in progress and
+// the slot's sequence number is not larger. Otherwise the caller has to look
+// the key up in the DB.
+//
+// All writes to the DB must be reported with BeginWrite() before they are
+// written and EndWrite() after they are done. Thread-safe and lock-free.
+class OptimisticKeyVersionCache {
+ public:
+  // Writes up to start_seq are not tracked.
+  OptimisticKeyVersionCache(size_t num_slots, SequenceNumber start_seq);
+
+  // A write reported with BeginWrite(), to be passed to EndWrite()
+  struct PendingWrite {
+    std::vector<size_t> slots;
+    // The keys of the batch could not be read. The write is tracked as a
+    // write to every key.
+    bool untracked = false;
+  };
+
+  void BeginWrite(const WriteBatch& batch, PendingWrite* write);
+
+  // seq must not be smaller than the sequence numbers used by the write.
+  void EndWrite(const PendingWrite& write, SequenceNumber seq);
+
+  // Returns true if the key is known not to have been written with a sequence
+  // number larger than seq. own_write is an optional write in progress by the
+  // caller, that is not counted.
+  bool NotWrittenAfter(uint32_t column_family_id, const Slice& key,
+                       SequenceNumber seq,
+                       const PendingWrite* own_write = nullptr) const;
+
+ private:
+  struct Slot {
+    std::atomic<SequenceNumber> seq{0};
+    std::atomic<uint32_t> writers{0};
+  };
+
+  size_t SlotIndex(uint32_t column_family_id, const Slice& key) const;
+
+  static void UpdateMax(std::atomic<SequenceNumber>* value,
+                        SequenceNumber seq);
+
+  const size_t num_slots_;
+  std::unique_ptr<Slot[]> slots_;
+  // Sequence numbers up to min_seq_ are not tracked
+  std::atomic<SequenceNumber> min_seq_;
+  // Number of untracked writes in progress
+  std::atomic<uint32_t> untracked_writers_{0};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -80,9 +80,26 @@ Status OptimisticTransaction::CommitWithSerialValidate() {
 
   DBImpl* db_impl = static_cast_with_check<DBImpl>(db_->GetRootDB());
 
+  auto txn_db_impl = static_cast_with_check<OptimisticTransactionDBImpl,
+                                            OptimisticTransactionDB>(txn_db_);
+  OptimisticKeyVersionCache* key_versions = txn_db_impl->GetKeyVersionCache();
+  OptimisticKeyVersionCache::PendingWrite pending_write;
+  if (key_versions != nullptr) {
+    // Reported before validation, which is done within the write. The
+    // validation does not count this write as a conflict.
+    key_versions->BeginWrite(*GetWriteBatch()->GetWriteBatch(),
+                             &pending_write);
+    pending_write_ = &pending_write;
+  }
+
   Status s = db_impl->WriteWithCallback(
       write_options_, GetWriteBatch()->GetWriteBatch(), &callback);
 
+  if (key_versions != nullptr) {
+    key_versions->EndWrite(pending_write, db_impl->GetLatestSequenceNumber());
+    pending_write_ = nullptr;
+  }
+
   if (s.ok()) {
     Clear();
   }
@@ -119,13 +136,22 @@ Status OptimisticTransaction::CommitWithParallelValidate() {
     lks.emplace_back(txn_db_impl->LockBucket(v));
   }
 
-  Status s = TransactionUtil::CheckKeysForConflicts(db_impl, *tracked_locks_,
-                                                    true /* cache_only */);
+  OptimisticKeyVersionCache* key_versions = txn_db_impl->GetKeyVersionCache();
+  Status s = TransactionUtil::CheckKeysForConflicts(
+      db_impl, *tracked_locks_, true /* cache_only */, key_versions);
   if (!s.ok()) {
     return s;
   }
 
-  s = db_impl->Write(write_options_, GetWriteBatch()->GetWriteBatch());
+  if (key_versions != nullptr) {
+    OptimisticKeyVersionCache::PendingWrite pending_write;
+    key_versions->BeginWrite(*GetWriteBatch()->GetWriteBatch(),
+                             &pending_write);
+    s = db_impl->Write(write_options_, GetWriteBatch()->GetWriteBatch());
+    key_versions->EndWrite(pending_write, db_impl->GetLatestSequenceNumber());
+  } else {
+    s = db_impl->Write(write_options_, GetWriteBatch()->GetWriteBatch());
+  }
   if (s.ok()) {
     Clear();
   }
@@ -182,8 +208,11 @@ Status OptimisticTransaction::CheckTransactionForConflicts(DB* db) {
   // we will do a cache-only conflict check.  This can result in TryAgain
   // getting returned if there is not sufficient memtable history to check
   // for conflicts.
-  return TransactionUtil::CheckKeysForConflicts(db_impl, *tracked_locks_,
-                                                true /* cache_only */);
+  auto txn_db_impl = static_cast_with_check<OptimisticTransactionDBImpl,
+                                            OptimisticTransactionDB>(txn_db_);
+  return TransactionUtil::CheckKeysForConflicts(
+      db_impl, *tracked_locks_, true /* cache_only */,
+      txn_db_impl->GetKeyVersionCache(), pending_write_);
 }
 
 Status OptimisticTransaction::SetName(const TransactionName& /* unused */) {
@@ -20,6 +20,7 @@
 #include "rocksdb/utilities/optimistic_transaction_db.h"
 #include "rocksdb/utilities/transaction.h"
 #include "rocksdb/utilities/write_batch_with_index.h"
+#include "utilities/transactions/optimistic_key_version_cache.h"
 #include "utilities/transactions/transaction_base.h"
 #include "utilities/transactions/transaction_util.h"
 
@@ -56,6 +57,10 @@ class OptimisticTransaction : public TransactionBaseImpl {
  private:
   ROCKSDB_FIELD_UNUSED OptimisticTransactionDB* const txn_db_;
 
+  // The write of this transaction reported to the key version cache while
+  // it is being committed with CommitWithSerialValidate()
+  const OptimisticKeyVersionCache::PendingWrite* pending_write_ = nullptr;
+
   friend class OptimisticTransactionCallback;
 
   void Initialize(const OptimisticTransactionOptions& txn_options);
@@ -12,6 +12,7 @@
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
+#include "utilities/transactions/optimistic_key_version_cache.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -31,6 +32,10 @@ class OptimisticTransactionDBImpl : public OptimisticTransactionDB {
             std::unique_ptr<std::mutex>(new std::mutex));
       }
     }
+    if (occ_options.key_version_cache_slots > 0) {
+      key_versions_.reset(new OptimisticKeyVersionCache(
+          occ_options.key_version_cache_slots, db->GetLatestSequenceNumber()));
+    }
   }
 
   ~OptimisticTransactionDBImpl() {
@@ -59,7 +64,55 @@ class OptimisticTransactionDBImpl : public OptimisticTransactionDB {
     if (batch->HasDeleteRange()) {
       return Status::NotSupported();
     }
-    return OptimisticTransactionDB::Write(write_opts, batch);
+    if (key_versions_ == nullptr) {
+      return OptimisticTransactionDB::Write(write_opts, batch);
+    }
+    OptimisticKeyVersionCache::PendingWrite pending_write;
+    key_versions_->BeginWrite(*batch, &pending_write);
+    Status s = OptimisticTransactionDB::Write(write_opts, batch);
+    key_versions_->EndWrite(pending_write, GetLatestSequenceNumber());
+    return s;
+  }
+
+  // With a key version cache, single key writes go through Write() so that
+  // the cache sees them. Keys with timestamps are not tracked by the cache.
+  using StackableDB::Put;
+  Status Put(const WriteOptions& options, ColumnFamilyHandle* column_family,
+             const Slice& key, const Slice& val) override {
+    return key_versions_ ? DB::Put(options, column_family, key, val)
+                         : StackableDB::Put(options, column_family, key, val);
+  }
+
+  using StackableDB::PutEntity;
+  Status PutEntity(const WriteOptions& options,
+                   ColumnFamilyHandle* column_family, const Slice& key,
+                   const WideColumns& columns) override {
+    return key_versions_
+               ? DB::PutEntity(options, column_family, key, columns)
+               : StackableDB::PutEntity(options, column_family, key, columns);
+  }
+
+  using StackableDB::Delete;
+  Status Delete(const WriteOptions& wopts, ColumnFamilyHandle* column_family,
+                const Slice& key) override {
+    return key_versions_ ? DB::Delete(wopts, column_family, key)
+                         : StackableDB::Delete(wopts, column_family, key);
+  }
+
+  using StackableDB::SingleDelete;
+  Status SingleDelete(const WriteOptions& wopts,
+                      ColumnFamilyHandle* column_family,
+                      const Slice& key) override {
+    return key_versions_ ? DB::SingleDelete(wopts, column_family, key)
+                         : StackableDB::SingleDelete(wopts, column_family, key);
+  }
+
+  using StackableDB::Merge;
+  Status Merge(const WriteOptions& options, ColumnFamilyHandle* column_family,
+               const Slice& key, const Slice& value) override {
+    return key_versions_ ? DB::Merge(options, column_family, key, value)
+                         : StackableDB::Merge(options, column_family, key,
+                                              value);
   }
 
   size_t GetLockBucketsSize() const { return bucketed_locks_.size(); }
@@ -68,6 +121,11 @@ class OptimisticTransactionDBImpl : public OptimisticTransactionDB {
 
   std::unique_lock<std::mutex> LockBucket(size_t idx);
 
+  // nullptr if OptimisticTransactionDBOptions::key_version_cache_slots is 0
+  OptimisticKeyVersionCache* GetKeyVersionCache() const {
+    return key_versions_.get();
+  }
+
  private:
   // NOTE: used in validation phase. Each key is hashed into some
   // bucket. We then take the lock in the hash value order to avoid deadlock.
@@ -77,6 +135,8 @@ class OptimisticTransactionDBImpl : public OptimisticTransactionDB {
 
   const OccValidationPolicy validate_policy_;
 
+  std::unique_ptr<OptimisticKeyVersionCache> key_versions_;
+
   void ReinitializeTransaction(Transaction* txn,
                                const WriteOptions& write_options,
                                const OptimisticTransactionOptions& txn_options =
@@ -30,6 +30,7 @@ class OptimisticTransactionTest
   OptimisticTransactionDB* txn_db;
   std::string dbname;
   Options options;
+  size_t key_version_cache_slots = 0;
 
   OptimisticTransactionTest() {
     options.create_if_missing = true;
@@ -57,6 +58,7 @@ class OptimisticTransactionTest
     ColumnFamilyOptions cf_options(options);
     OptimisticTransactionDBOptions occ_opts;
     occ_opts.validate_policy = GetParam();
+    occ_opts.key_version_cache_slots = key_version_cache_slots;
     std::vector<ColumnFamilyDescriptor> column_families;
     std::vector<ColumnFamilyHandle*> handles;
     column_families.push_back(
@@ -479,6 +481,71 @@ TEST_P(OptimisticTransactionTest, CheckKeySkipOldMemtable) {
   }
 }
 
+TEST_P(OptimisticTransactionTest, KeyVersionCache) {
+  key_version_cache_slots = 1 << 16;
+  Reopen();
+
+  WriteOptions write_options;
+  ReadOptions read_options;
+  std::string value;
+  ASSERT_OK(txn_db->Put(write_options, "foo", "bar"));
+  ASSERT_OK(txn_db->Put(write_options, "foo2", "bar"));
+
+  SetPerfLevel(PerfLevel::kEnableCount);
+
+  // No write since the keys were read: validated without memtable lookups
+  std::unique_ptr<Transaction> txn(txn_db->BeginTransaction(write_options));
+  ASSERT_OK(txn->GetForUpdate(read_options, "foo", &value));
+  ASSERT_OK(txn->Put("foo2", "bar2"));
+  get_perf_context()->Reset();
+  ASSERT_OK(txn->Commit());
+  ASSERT_EQ(0, get_perf_context()->get_from_memtable_count);
+
+  // Conflicts with a write of the DB
+  txn.reset(txn_db->BeginTransaction(write_options));
+  ASSERT_OK(txn->GetForUpdate(read_options, "foo", &value));
+  ASSERT_OK(txn->Put("foo", "bar3"));
+  ASSERT_OK(txn_db->Put(write_options, "foo", "bar4"));
+  ASSERT_TRUE(txn->Commit().IsBusy());
+
+  // Conflicts with a write batch written to the DB
+  txn.reset(txn_db->BeginTransaction(write_options));
+  ASSERT_OK(txn->GetForUpdate(read_options, "foo", &value));
+  WriteBatch batch;
+  ASSERT_OK(batch.Merge("foo", "bar5"));
+  ASSERT_OK(txn_db->Write(write_options, &batch));
+  ASSERT_TRUE(txn->Commit().IsBusy());
+
+  // Conflicts with another transaction
+  txn.reset(txn_db->BeginTransaction(write_options));
+  std::unique_ptr<Transaction> txn2(txn_db->BeginTransaction(write_options));
+  ASSERT_OK(txn->GetForUpdate(read_options, "foo", &value));
+  ASSERT_OK(txn2->GetForUpdate(read_options, "foo", &value));
+  ASSERT_OK(txn->Put("foo", "bar6"));
+  ASSERT_OK(txn2->Put("foo", "bar7"));
+  ASSERT_OK(txn->Commit());
+  ASSERT_TRUE(txn2->Commit().IsBusy());
+  ASSERT_OK(txn_db->Get(read_options, "foo", &value));
+  ASSERT_EQ("bar6", value);
+
+  // A write of another key is not a conflict
+  txn.reset(txn_db->BeginTransaction(write_options));
+  ASSERT_OK(txn->GetForUpdate(read_options, "foo", &value));
+  ASSERT_OK(txn_db->Delete(write_options, "foo2"));
+  ASSERT_OK(txn->Put("foo", "bar8"));
+  ASSERT_OK(txn->Commit());
+
+  // Keys written before the snapshot are not conflicts
+  txn.reset(txn_db->BeginTransaction(write_options));
+  ASSERT_OK(txn->GetForUpdate(read_options, "foo", &value));
+  ASSERT_EQ("bar8", value);
+  get_perf_context()->Reset();
+  ASSERT_OK(txn->Commit());
+  ASSERT_EQ(0, get_perf_context()->get_from_memtable_count);
+
+  SetPerfLevel(PerfLevel::kDisable);
+}
+
 TEST_P(OptimisticTransactionTest, NoSnapshotTest) {
   WriteOptions write_options;
   ReadOptions read_options;
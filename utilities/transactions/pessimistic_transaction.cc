@@ -74,6 +74,7 @@ void PessimisticTransaction::Initialize(const TransactionOptions& txn_options) {
   deadlock_detect_ = txn_options.deadlock_detect;
   deadlock_detect_depth_ = txn_options.deadlock_detect_depth;
   write_batch_.SetMaxBytes(txn_options.max_write_batch_size);
+  write_batch_.SetLazyIndexing(txn_options.lazy_write_batch_index);
   skip_concurrency_control_ = txn_options.skip_concurrency_control;
 
   lock_timeout_ = txn_options.lock_timeout * 1000;
@@ -875,9 +876,8 @@ Status PessimisticTransaction::LockBatch(WriteBatch* batch,
   class Handler : public WriteBatch::Handler {
    public:
     // Sorted map of column_family_id to sorted set of keys.
-    // Since LockBatch() always locks keys in sorted order, it cannot deadlock
-    // with itself.  We're not using a comparator here since it doesn't matter
-    // what the sorting is as long as it's consistent.
+    // Since LockBatch() always locks keys in the same order (see
+    // LockManager::TryLockKeys()), it cannot deadlock with itself.
     std::map<uint32_t, std::set<std::string>> keys_;
 
     Handler() {}
@@ -916,18 +916,17 @@ Status PessimisticTransaction::LockBatch(WriteBatch* batch,
     return s;
   }
 
-  // Attempt to lock all keys
+  // Attempt to lock all keys, one column family at a time
   for (const auto& cf_iter : handler.keys_) {
     uint32_t cfh_id = cf_iter.first;
     auto& cfh_keys = cf_iter.second;
 
-    for (const auto& key_iter : cfh_keys) {
-      const std::string& key = key_iter;
-
-      s = txn_db_impl_->TryLock(this, cfh_id, key, true /* exclusive */);
-      if (!s.ok()) {
-        break;
-      }
+    std::vector<std::string> keys(cfh_keys.begin(), cfh_keys.end());
+    s = txn_db_impl_->TryLockKeys(this, cfh_id, keys, true /* exclusive */);
+    if (!s.ok()) {
+      break;
+    }
+    for (const std::string& key : keys) {
       PointLockRequest r;
       r.column_family_id = cfh_id;
       r.key = key;
@@ -936,10 +935,6 @@ Status PessimisticTransaction::LockBatch(WriteBatch* batch,
       r.exclusive = true;
       keys_to_unlock->Track(r);
     }
-
-    if (!s.ok()) {
-      break;
-    }
   }
 
   if (!s.ok()) {
@@ -986,6 +981,16 @@ Status PessimisticTransaction::TryLock(ColumnFamilyHandle* column_family,
     s = txn_db_impl_->TryLock(this, cfh_id, key_str, exclusive);
   }
 
+  return ValidateAndTrackLock(column_family, key, key_str, cfh_id, status,
+                              previously_locked, lock_upgrade, read_only,
+                              exclusive, do_validate, assume_tracked, s);
+}
+
+Status PessimisticTransaction::ValidateAndTrackLock(
+    ColumnFamilyHandle* column_family, const Slice& key,
+    const std::string& key_str, uint32_t cfh_id, const PointLockStatus& status,
+    bool previously_locked, bool lock_upgrade, bool read_only, bool exclusive,
+    const bool do_validate, const bool assume_tracked, Status s) {
   const ColumnFamilyHandle* const cfh =
       column_family ? column_family : db_impl_->DefaultColumnFamily();
   assert(cfh);
@@ -1073,6 +1078,78 @@ Status PessimisticTransaction::TryLock(ColumnFamilyHandle* column_family,
   return s;
 }
 
+Status PessimisticTransaction::LockKeys(ColumnFamilyHandle* column_family,
+                                        const std::vector<Slice>& keys,
+                                        bool exclusive) {
+  if (UNLIKELY(skip_concurrency_control_)) {
+    return Status::OK();
+  }
+  column_family =
+      column_family ? column_family : db_impl_->DefaultColumnFamily();
+  assert(column_family);
+  if (!tracked_locks_->IsPointLockSupported() ||
+      column_family->GetComparator()->timestamp_size() != 0) {
+    for (const Slice& key : keys) {
+      Status s = GetForUpdate(ReadOptions(), column_family, key,
+                              static_cast<std::string*>(nullptr), exclusive,
+                              true /* do_validate */);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    return Status::OK();
+  }
+  uint32_t cfh_id = GetColumnFamilyID(column_family);
+
+  // Keys this transaction already holds go through TryLock() below, which
+  // also takes care of lock upgrades.
+  std::vector<std::string> keys_to_lock;
+  for (const Slice& key : keys) {
+    std::string key_str = key.ToString();
+    if (!tracked_locks_->GetPointLockStatus(cfh_id, key_str).locked) {
+      keys_to_lock.push_back(std::move(key_str));
+    }
+  }
+  std::sort(keys_to_lock.begin(), keys_to_lock.end());
+  keys_to_lock.erase(std::unique(keys_to_lock.begin(), keys_to_lock.end()),
+                     keys_to_lock.end());
+
+  Status s;
+  if (!keys_to_lock.empty()) {
+    s = txn_db_impl_->TryLockKeys(this, cfh_id, keys_to_lock, exclusive);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  for (const Slice& key : keys) {
+    std::string key_str = key.ToString();
+    PointLockStatus status = tracked_locks_->GetPointLockStatus(cfh_id, key_str);
+    if (status.locked) {
+      s = TryLock(column_family, key, true /* read_only */, exclusive);
+    } else {
+      // Locked by TryLockKeys() above
+      s = ValidateAndTrackLock(column_family, key, key_str, cfh_id, status,
+                               false /* previously_locked */,
+                               false /* lock_upgrade */, true /* read_only */,
+                               exclusive, true /* do_validate */,
+                               false /* assume_tracked */, Status::OK());
+    }
+    if (!s.ok()) {
+      // Release the keys locked above that were not tracked yet. The failed
+      // key itself has been released already.
+      for (const std::string& locked_key : keys_to_lock) {
+        if (locked_key != key_str &&
+            !tracked_locks_->GetPointLockStatus(cfh_id, locked_key).locked) {
+          txn_db_impl_->UnLock(this, cfh_id, locked_key);
+        }
+      }
+      return s;
+    }
+  }
+  return s;
+}
+
 Status PessimisticTransaction::GetRangeLock(ColumnFamilyHandle* column_family,
                                             const Endpoint& start_endp,
                                             const Endpoint& end_endp) {
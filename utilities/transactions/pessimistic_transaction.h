@@ -119,6 +119,9 @@ class PessimisticTransaction : public TransactionBaseImpl {
                               const Endpoint& start_key,
                               const Endpoint& end_key) override;
 
+  Status LockKeys(ColumnFamilyHandle* column_family,
+                  const std::vector<Slice>& keys, bool exclusive) override;
+
  protected:
   // Refer to
   // TransactionOptions::use_only_the_last_commit_time_batch_for_recovery
@@ -148,6 +151,17 @@ class PessimisticTransaction : public TransactionBaseImpl {
                  bool read_only, bool exclusive, const bool do_validate = true,
                  const bool assume_tracked = false) override;
 
+  // The part of TryLock() that follows the lock manager call: validates the
+  // key against the snapshot and tracks the lock. `s` is the result of
+  // locking the key.
+  Status ValidateAndTrackLock(ColumnFamilyHandle* column_family,
+                              const Slice& key, const std::string& key_str,
+                              uint32_t cfh_id, const PointLockStatus& status,
+                              bool previously_locked, bool lock_upgrade,
+                              bool read_only, bool exclusive,
+                              const bool do_validate,
+                              const bool assume_tracked, Status s);
+
   void Clear() override;
 
   PessimisticTransactionDB* txn_db_impl_;
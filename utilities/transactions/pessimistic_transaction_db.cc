@@ -461,6 +461,12 @@ Status PessimisticTransactionDB::TryLock(PessimisticTransaction* txn,
   return lock_manager_->TryLock(txn, cfh_id, key, GetEnv(), exclusive);
 }
 
+Status PessimisticTransactionDB::TryLockKeys(
+    PessimisticTransaction* txn, uint32_t cfh_id,
+    const std::vector<std::string>& keys, bool exclusive) {
+  return lock_manager_->TryLockKeys(txn, cfh_id, keys, GetEnv(), exclusive);
+}
+
 Status PessimisticTransactionDB::TryRangeLock(PessimisticTransaction* txn,
                                               uint32_t cfh_id,
                                               const Endpoint& start_endp,
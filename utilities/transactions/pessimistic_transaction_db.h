@@ -117,6 +117,8 @@ class PessimisticTransactionDB : public TransactionDB {
 
   Status TryLock(PessimisticTransaction* txn, uint32_t cfh_id,
                  const std::string& key, bool exclusive);
+  Status TryLockKeys(PessimisticTransaction* txn, uint32_t cfh_id,
+                     const std::vector<std::string>& keys, bool exclusive);
   Status TryRangeLock(PessimisticTransaction* txn, uint32_t cfh_id,
                       const Endpoint& start_endp, const Endpoint& end_endp);
 
@@ -3582,6 +3582,50 @@ TEST_P(TransactionTest, Rollback) {
   delete txn2;
 }
 
+TEST_P(TransactionTest, LockKeys) {
+  WriteOptions write_options;
+  TransactionOptions txn_options;
+
+  std::vector<std::string> key_strs;
+  for (int i = 0; i < 100; i++) {
+    key_strs.push_back("key" + std::to_string(i));
+  }
+  std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+
+  Transaction* txn1 = db->BeginTransaction(write_options, txn_options);
+  ASSERT_OK(txn1->LockKeys(nullptr, keys));
+  // Keys that are already locked and duplicates are fine
+  ASSERT_OK(txn1->LockKeys(nullptr, {keys[0], Slice("key100"), keys[0]}));
+
+  // Conflicts with txn1, so none of the keys stays locked
+  Transaction* txn2 = db->BeginTransaction(write_options, txn_options);
+  ASSERT_TRUE(
+      txn2->LockKeys(nullptr, {Slice("other"), keys[50]}).IsTimedOut());
+  Transaction* txn3 = db->BeginTransaction(write_options, txn_options);
+  ASSERT_OK(txn3->Put("other", "v"));
+  ASSERT_OK(txn3->Rollback());
+  delete txn3;
+
+  for (const Slice& key : keys) {
+    ASSERT_OK(txn1->Put(key, "v1"));
+  }
+  ASSERT_OK(txn1->Commit());
+  delete txn1;
+
+  // Validation against the snapshot fails on the key written after it
+  txn2->SetSnapshot();
+  ASSERT_OK(db->Put(write_options, "key5", "v2"));
+  ASSERT_TRUE(
+      txn2->LockKeys(nullptr, {keys[4], keys[5], keys[6]}).IsBusy());
+  txn3 = db->BeginTransaction(write_options, txn_options);
+  ASSERT_OK(txn3->Put(keys[5], "v3"));
+  ASSERT_OK(txn3->Put(keys[6], "v3"));
+  ASSERT_OK(txn3->Commit());
+  delete txn3;
+  ASSERT_OK(txn2->Rollback());
+  delete txn2;
+}
+
 TEST_P(TransactionTest, LockLimitTest) {
   WriteOptions write_options;
   ReadOptions read_options, snapshot_read_options;
@@ -149,9 +149,10 @@ Status TransactionUtil::CheckKey(DBImpl* db_impl, SuperVersion* sv,
   return result;
 }
 
-Status TransactionUtil::CheckKeysForConflicts(DBImpl* db_impl,
-                                              const LockTracker& tracker,
-                                              bool cache_only) {
+Status TransactionUtil::CheckKeysForConflicts(
+    DBImpl* db_impl, const LockTracker& tracker, bool cache_only,
+    const OptimisticKeyVersionCache* key_versions,
+    const OptimisticKeyVersionCache::PendingWrite* own_write) {
   Status result;
 
   std::unique_ptr<LockTracker::ColumnFamilyIterator> cf_it(
@@ -169,6 +170,11 @@ Status TransactionUtil::CheckKeysForConflicts(DBImpl* db_impl,
 
     SequenceNumber earliest_seq =
         db_impl->GetEarliestMemTableSequenceNumber(sv, true);
+    // Keys of column families with timestamps are written with their
+    // timestamp, and cannot be found in key_versions.
+    const bool use_key_versions =
+        key_versions != nullptr &&
+        sv->cfd->user_comparator()->timestamp_size() == 0;
 
     // For each of the keys in this transaction, check to see if someone has
     // written to this key since the start of the transaction.
@@ -180,6 +186,11 @@ Status TransactionUtil::CheckKeysForConflicts(DBImpl* db_impl,
       PointLockStatus status = tracker.GetPointLockStatus(cf, key);
       const SequenceNumber key_seq = status.seq;
 
+      if (use_key_versions &&
+          key_versions->NotWrittenAfter(cf, key, key_seq, own_write)) {
+        continue;
+      }
+
       // TODO: support timestamp-based conflict checking.
       // CheckKeysForConflicts() is currently used only by optimistic
       // transactions.
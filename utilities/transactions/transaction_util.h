@@ -16,6 +16,7 @@
 #include "rocksdb/status.h"
 #include "rocksdb/types.h"
 #include "utilities/transactions/lock/lock_tracker.h"
+#include "utilities/transactions/optimistic_key_version_cache.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -52,13 +53,18 @@ class TransactionUtil {
   // Returns OK on success, BUSY if there is a conflicting write, or other error
   // status for any unexpected errors.
   //
+  // If key_versions is provided, keys it knows were not written since their
+  // sequence number are not looked up in the db. own_write is the write of
+  // the caller reported to key_versions, if any.
+  //
   // REQUIRED:
   // This function should only be called on the write thread or if the
   // mutex is held.
   // tracker must support point lock.
-  static Status CheckKeysForConflicts(DBImpl* db_impl,
-                                      const LockTracker& tracker,
-                                      bool cache_only);
+  static Status CheckKeysForConflicts(
+      DBImpl* db_impl, const LockTracker& tracker, bool cache_only,
+      const OptimisticKeyVersionCache* key_versions = nullptr,
+      const OptimisticKeyVersionCache::PendingWrite* own_write = nullptr);
 
  private:
   // If `snap_checker` == nullptr, writes are always commited in sequence number
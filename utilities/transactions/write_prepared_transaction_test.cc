@@ -272,16 +272,22 @@ TEST(WriteBatchWithIndex, SubBatchCnt) {
     for (size_t i = 0; i < 1000; i++) {  // 1000 random batches
       WriteBatchWithIndex rndbatch(db->DefaultColumnFamily()->GetComparator(),
                                    0, true, 0);
+      // The same batch, indexed lazily when SubBatchCnt() is called
+      WriteBatchWithIndex lazybatch(db->DefaultColumnFamily()->GetComparator(),
+                                    0, true, 0);
+      lazybatch.SetLazyIndexing(true);
       for (size_t k = 0; k < 10; k++) {  // 10 key per batch
         size_t ki = static_cast<size_t>(rnd.Uniform(TOTAL_KEYS));
         Slice key = Slice(keys[ki]);
         std::string tmp = rnd.RandomString(16);
         Slice value = Slice(tmp);
         ASSERT_OK(rndbatch.Put(key, value));
+        ASSERT_OK(lazybatch.Put(key, value));
       }
       SubBatchCounter batch_counter(comparators);
       ASSERT_OK(rndbatch.GetWriteBatch()->Iterate(&batch_counter));
       ASSERT_EQ(rndbatch.SubBatchCnt(), batch_counter.BatchCount());
+      ASSERT_EQ(lazybatch.SubBatchCnt(), batch_counter.BatchCount());
     }
   }
 
@@ -1460,6 +1466,57 @@ TEST_P(WritePreparedTransactionTest, MaxCatchupWithUnbackedSnapshot) {
   db->ReleaseSnapshot(snap);
 }
 
+// Read from more snapshots than fit into the snapshot cache while commits keep
+// evicting entries from the commit cache.
+TEST_P(WritePreparedTransactionTest, ManySnapshotsConcurrentReads) {
+  const size_t snapshot_cache_bits = 1;  // 2 entries
+  const size_t commit_cache_bits = 0;    // only 1 entry => frequent eviction
+  UpdateTransactionDBOptions(snapshot_cache_bits, commit_cache_bits);
+  ASSERT_OK(ReOpen());
+  WriteOptions woptions;
+
+  const int kSnapshots = 16;
+  std::vector<const Snapshot*> snapshots;
+  std::vector<std::string> expected;
+  for (int i = 0; i < kSnapshots; i++) {
+    std::string value = "v" + std::to_string(i);
+    ASSERT_OK(db->Put(woptions, "key", value));
+    snapshots.push_back(db->GetSnapshot());
+    expected.push_back(value);
+    ASSERT_OK(db->Put(woptions, "other", value));
+  }
+
+  std::atomic<bool> stop{false};
+  ROCKSDB_NAMESPACE::port::Thread writer([&]() {
+    for (int i = 0; !stop.load(); i++) {
+      ASSERT_OK(db->Put(woptions, "key", "w" + std::to_string(i)));
+    }
+  });
+  std::vector<ROCKSDB_NAMESPACE::port::Thread> readers;
+  for (int t = 0; t < 2; t++) {
+    readers.emplace_back([&]() {
+      for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < kSnapshots; i++) {
+          ReadOptions ropt;
+          ropt.snapshot = snapshots[i];
+          PinnableSlice value;
+          ASSERT_OK(db->Get(ropt, db->DefaultColumnFamily(), "key", &value));
+          ASSERT_EQ(expected[i], value.ToString());
+        }
+      }
+    });
+  }
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  stop.store(true);
+  writer.join();
+
+  for (auto snapshot : snapshots) {
+    db->ReleaseSnapshot(snapshot);
+  }
+}
+
 // Check that old_commit_map_ cleanup works correctly if the snapshot equals
 // max_evicted_seq_.
 TEST_P(WritePreparedTransactionTest, CleanupSnapshotEqualToMax) {
@@ -422,6 +422,8 @@ void WritePreparedTxnDB::Init(const TransactionDBOptions& txn_db_opts) {
       new std::atomic<SequenceNumber>[SNAPSHOT_CACHE_SIZE] {});
   commit_cache_ = std::unique_ptr<std::atomic<CommitEntry64b>[]>(
       new std::atomic<CommitEntry64b>[COMMIT_CACHE_SIZE] {});
+  old_commit_filter_ = std::unique_ptr<std::atomic<uint32_t>[]>(
+      new std::atomic<uint32_t>[OLD_COMMIT_FILTER_SIZE] {});
   dummy_max_snapshot_.number_ = kMaxSequenceNumber;
   rollback_deletion_type_callback_ =
       txn_db_opts.rollback_deletion_type_callback;
@@ -675,6 +677,7 @@ void WritePreparedTxnDB::AdvanceMaxEvictedSeq(const SequenceNumber& prev_max,
         // snapshots from the reads from committed values in valid snapshots.
         old_commit_map_[snap];
       }
+      PublishOldCommitSnapshots();
       old_commit_map_empty_.store(false, std::memory_order_release);
     }
   }
@@ -806,7 +809,15 @@ void WritePreparedTxnDB::ReleaseSnapshotInternal(
       ROCKS_LOG_WARN(info_log_, "old_commit_map_mutex_ overhead for %" PRIu64,
                      snap_seq);
       WriteLock wl(&old_commit_map_mutex_);
-      old_commit_map_.erase(snap_seq);
+      auto prep_set_entry = old_commit_map_.find(snap_seq);
+      if (prep_set_entry != old_commit_map_.end()) {
+        for (auto prep_seq : prep_set_entry->second) {
+          old_commit_filter_[prep_seq & (OLD_COMMIT_FILTER_SIZE - 1)].fetch_sub(
+              1, std::memory_order_release);
+        }
+        old_commit_map_.erase(prep_set_entry);
+        PublishOldCommitSnapshots();
+      }
       old_commit_map_empty_.store(old_commit_map_.empty(),
                                   std::memory_order_release);
     }
@@ -879,11 +890,12 @@ void WritePreparedTxnDB::UpdateSnapshots(
     TEST_IDX_SYNC_POINT("WritePreparedTxnDB::UpdateSnapshots:s:", sync_i);
   }
 #endif
-  snapshots_.clear();
-  for (; it != snapshots.end(); ++it) {
-    // Insert them to a vector that is less efficient to access
-    // concurrently
-    snapshots_.push_back(*it);
+  if (SNAPSHOT_CACHE_SIZE < snapshots.size() ||
+      SNAPSHOT_CACHE_SIZE < snapshots_total_.load(std::memory_order_relaxed)) {
+    // Publish the whole list for the readers that need more than
+    // snapshot_cache_, including the ones that read snapshots_total_ of an
+    // older version that did not fit into snapshot_cache_.
+    snapshots_.Publish(snapshots);
   }
   // Update the size at the end. Otherwise a parallel reader might read
   // items that are not set yet.
@@ -944,22 +956,15 @@ void WritePreparedTxnDB::CheckAgainstSnapshots(const CommitEntry& evicted) {
     // Then access the less efficient list of snapshots_
     WPRecordTick(TXN_SNAPSHOT_MUTEX_OVERHEAD);
     ROCKS_LOG_WARN(info_log_,
-                   "snapshots_mutex_ overhead for <%" PRIu64 ",%" PRIu64
+                   "snapshots_ overhead for <%" PRIu64 ",%" PRIu64
                    "> with %" ROCKSDB_PRIszt " snapshots",
                    evicted.prep_seq, evicted.commit_seq, cnt);
-    ReadLock rl(&snapshots_mutex_);
-    // Items could have moved from the snapshots_ to snapshot_cache_ before
-    // accquiring the lock. To make sure that we do not miss a valid snapshot,
-    // read snapshot_cache_ again while holding the lock.
-    for (size_t i = 0; i < SNAPSHOT_CACHE_SIZE; i++) {
-      SequenceNumber snapshot_seq =
-          snapshot_cache_[i].load(std::memory_order_acquire);
-      if (!MaybeUpdateOldCommitMap(evicted.prep_seq, evicted.commit_seq,
-                                   snapshot_seq, next_is_larger)) {
-        break;
-      }
-    }
-    for (auto snapshot_seq_2 : snapshots_) {
+    // Items could have moved from the snapshots_ to snapshot_cache_ since it
+    // was read. snapshots_ has the whole list of a single version, so reading
+    // it from the start does not miss a valid snapshot.
+    PublishedVersion<std::vector<SequenceNumber>>::ReadGuard snapshots(
+        &snapshots_);
+    for (auto snapshot_seq_2 : *snapshots) {
       if (!MaybeUpdateOldCommitMap(evicted.prep_seq, evicted.commit_seq,
                                    snapshot_seq_2, next_is_larger)) {
         break;
@@ -987,6 +992,13 @@ bool WritePreparedTxnDB::MaybeUpdateOldCommitMap(
                    snapshot_seq, prep_seq, commit_seq);
     WriteLock wl(&old_commit_map_mutex_);
     old_commit_map_empty_.store(false, std::memory_order_release);
+    old_commit_filter_[prep_seq & (OLD_COMMIT_FILTER_SIZE - 1)].fetch_add(
+        1, std::memory_order_release);
+    // A snapshot new to old_commit_map_ is not published here. Only the
+    // snapshots at or below max_evicted_seq_ are looked up in
+    // old_commit_snapshots_, and AdvanceMaxEvictedSeq publishes them before it
+    // advances max_evicted_seq_ past them. Publishing here would copy the
+    // whole list for each of the snapshots that the evicted entry overlaps.
     auto& vec = old_commit_map_[snapshot_seq];
     vec.insert(std::upper_bound(vec.begin(), vec.end(), prep_seq), prep_seq);
     // We need to store it once for each overlapping snapshot. Returning true to
@@ -997,6 +1009,15 @@ bool WritePreparedTxnDB::MaybeUpdateOldCommitMap(
   return next_is_larger;
 }
 
+void WritePreparedTxnDB::PublishOldCommitSnapshots() {
+  std::vector<SequenceNumber> old_commit_snapshots;
+  old_commit_snapshots.reserve(old_commit_map_.size());
+  for (const auto& entry : old_commit_map_) {
+    old_commit_snapshots.push_back(entry.first);
+  }
+  old_commit_snapshots_.Publish(std::move(old_commit_snapshots));
+}
+
 WritePreparedTxnDB::~WritePreparedTxnDB() {
   // At this point there could be running compaction/flush holding a
   // SnapshotChecker, which holds a pointer back to WritePreparedTxnDB.
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cinttypes>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <set>
@@ -22,6 +23,7 @@
 #include "rocksdb/options.h"
 #include "rocksdb/utilities/transaction_db.h"
 #include "util/cast_util.h"
+#include "util/published_version.h"
 #include "util/set_comparator.h"
 #include "util/string_util.h"
 #include "utilities/transactions/pessimistic_transaction.h"
@@ -282,6 +284,27 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
       *snap_released = true;
       return true;
     }
+    if (old_commit_filter_[prep_seq & (OLD_COMMIT_FILTER_SIZE - 1)].load(
+            std::memory_order_acquire) == 0) {
+      // prep_seq is not in old_commit_map_, so it only matters whether the
+      // snapshot is, which does not need old_commit_map_mutex_.
+      PublishedVersion<std::vector<SequenceNumber>>::ReadGuard
+          old_commit_snapshots(&old_commit_snapshots_);
+      if (!std::binary_search(old_commit_snapshots->begin(),
+                              old_commit_snapshots->end(), snapshot_seq)) {
+        ROCKS_LOG_DETAILS(info_log_,
+                          "IsInSnapshot %" PRIu64 " in %" PRIu64
+                          " returns %" PRId32 " released=1",
+                          prep_seq, snapshot_seq, 0);
+        assert(snap_released);
+        *snap_released = true;
+        return true;
+      }
+      ROCKS_LOG_DETAILS(
+          info_log_, "IsInSnapshot %" PRIu64 " in %" PRIu64 " returns %" PRId32,
+          prep_seq, snapshot_seq, 1);
+      return true;
+    }
     {
       // We should not normally reach here unless sapshot_seq is old. This is a
       // rare case and it is ok to pay the cost of mutex ReadLock for such old,
@@ -723,10 +746,17 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
   // for the in-flight commits to be visible.
   void AdvanceSeqByOne();
 
+  // Publishes the snapshots of old_commit_map_ to old_commit_snapshots_. Must
+  // be called with old_commit_map_mutex_ write locked after removing a
+  // snapshot from old_commit_map_, or adding one that IsInSnapshot may look
+  // up.
+  void PublishOldCommitSnapshots();
+
   // The list of live snapshots at the last time that max_evicted_seq_ advanced.
   // The list stored into two data structures: in snapshot_cache_ that is
-  // efficient for concurrent reads, and in snapshots_ if the data does not fit
-  // into snapshot_cache_. The total number of snapshots in the two lists
+  // efficient for concurrent reads, and in snapshots_ that has the whole list
+  // if it does not fit into snapshot_cache_. The total number of snapshots in
+  // the list
   std::atomic<size_t> snapshots_total_ = {};
   // The list sorted in ascending order. Thread-safety for writes is provided
   // with snapshots_mutex_ and concurrent reads are safe due to std::atomic for
@@ -735,9 +765,11 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
   const size_t SNAPSHOT_CACHE_BITS;
   const size_t SNAPSHOT_CACHE_SIZE;
   std::unique_ptr<std::atomic<SequenceNumber>[]> snapshot_cache_;
-  // 2nd list for storing snapshots. The list sorted in ascending order.
-  // Thread-safety is provided with snapshots_mutex_.
-  std::vector<SequenceNumber> snapshots_;
+  // 2nd list for storing snapshots. The list sorted in ascending order. Each
+  // version of the list is immutable: UpdateSnapshots replaces it with
+  // snapshots_mutex_ held, and readers pin the current version without the
+  // mutex. A reader thus sees either the old or the new list as a whole.
+  PublishedVersion<std::vector<SequenceNumber>> snapshots_;
   // The list of all snapshots: snapshots_ + snapshot_cache_. This list although
   // redundant but simplifies CleanupOldSnapshots implementation.
   // Thread-safety is provided with snapshots_mutex_.
@@ -779,6 +811,15 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
   // after each update.
   // Thread-safety is provided with old_commit_map_mutex_.
   std::map<SequenceNumber, std::vector<SequenceNumber>> old_commit_map_;
+  // The number of prepared sequence numbers in old_commit_map_ by their lowest
+  // bits. Updated with old_commit_map_mutex_ held, and read without it to tell
+  // that a prepared sequence number is in none of the vectors of
+  // old_commit_map_.
+  static const size_t OLD_COMMIT_FILTER_SIZE = 1 << 12;
+  std::unique_ptr<std::atomic<uint32_t>[]> old_commit_filter_;
+  // The snapshots of old_commit_map_, in ascending order. Immutable, replaced
+  // by PublishOldCommitSnapshots.
+  PublishedVersion<std::vector<SequenceNumber>> old_commit_snapshots_;
   // A set of long-running prepared transactions that are not finished by the
   // time max_evicted_seq_ advances their sequence number. This is expected to
   // be empty normally. Thread-safety is provided with prepared_mutex_.
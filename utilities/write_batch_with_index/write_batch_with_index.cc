@@ -6,7 +6,10 @@
 
 #include "rocksdb/utilities/write_batch_with_index.h"
 
+#include <algorithm>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "db/column_family.h"
 #include "db/db_impl/db_impl.h"
@@ -47,6 +50,18 @@ struct WriteBatchWithIndex::Rep {
   // Total number of sub-batches in the write batch. Default is 1.
   size_t sub_batch_cnt;
 
+  struct DeferredEntry {
+    WriteBatchIndexEntry* entry;
+    WriteType type;
+  };
+  // See WriteBatchWithIndex::SetLazyIndexing()
+  bool lazy_indexing = false;
+  // True while updates are appended to deferred_entries instead of being
+  // indexed. Reset to lazy_indexing by Clear().
+  bool defer_indexing = false;
+  // Updates not indexed yet, in the order they were written
+  std::vector<DeferredEntry> deferred_entries;
+
   // Remember current offset of internal write batch, which is used as
   // the starting offset of the next record.
   void SetLastEntryOffset() { last_entry_offset = write_batch.GetDataSize(); }
@@ -59,15 +74,26 @@ struct WriteBatchWithIndex::Rep {
   bool UpdateExistingEntryWithCfId(uint32_t column_family_id, const Slice& key,
                                    WriteType type);
 
+  // Returns the last index entry of the key, or nullptr if there is none.
+  WriteBatchIndexEntry* FindLastEntry(uint32_t column_family_id,
+                                      const Slice& key);
+
   // Add the recent entry to the update.
   // In overwrite mode, if key already exists in the index, update it.
   void AddOrUpdateIndex(ColumnFamilyHandle* column_family, const Slice& key,
                         WriteType type);
   void AddOrUpdateIndex(const Slice& key, WriteType type);
+  void AddOrUpdateIndexWithCfId(uint32_t column_family_id, const Slice& key,
+                                WriteType type);
 
   // Allocate an index entry pointing to the last entry in the write batch and
   // put it to skip list.
   void AddNewEntry(uint32_t column_family_id);
+  WriteBatchIndexEntry* NewIndexEntry(uint32_t column_family_id);
+
+  // Sort the deferred updates and add them to the skip list, with the same
+  // result as indexing them one by one. Stops deferring updates.
+  void IndexDeferredEntries();
 
   // Clear all updates buffered in this batch.
   void Clear();
@@ -84,19 +110,15 @@ bool WriteBatchWithIndex::Rep::UpdateExistingEntry(
   return UpdateExistingEntryWithCfId(cf_id, key, type);
 }
 
-bool WriteBatchWithIndex::Rep::UpdateExistingEntryWithCfId(
-    uint32_t column_family_id, const Slice& key, WriteType type) {
-  if (!overwrite_key) {
-    return false;
-  }
-
+WriteBatchIndexEntry* WriteBatchWithIndex::Rep::FindLastEntry(
+    uint32_t column_family_id, const Slice& key) {
   WBWIIteratorImpl iter(column_family_id, &skip_list, &write_batch,
                         &comparator);
   iter.Seek(key);
   if (!iter.Valid()) {
-    return false;
+    return nullptr;
   } else if (!iter.MatchesKey(column_family_id, key)) {
-    return false;
+    return nullptr;
   } else {
     // Move to the end of this key (NextKey-Prev)
     iter.NextKey();  // Move to the next key
@@ -106,8 +128,19 @@ bool WriteBatchWithIndex::Rep::UpdateExistingEntryWithCfId(
       iter.SeekToLast();
     }
   }
-  WriteBatchIndexEntry* non_const_entry =
-      const_cast<WriteBatchIndexEntry*>(iter.GetRawEntry());
+  return const_cast<WriteBatchIndexEntry*>(iter.GetRawEntry());
+}
+
+bool WriteBatchWithIndex::Rep::UpdateExistingEntryWithCfId(
+    uint32_t column_family_id, const Slice& key, WriteType type) {
+  if (!overwrite_key) {
+    return false;
+  }
+
+  WriteBatchIndexEntry* non_const_entry = FindLastEntry(column_family_id, key);
+  if (non_const_entry == nullptr) {
+    return false;
+  }
   if (LIKELY(last_sub_batch_offset <= non_const_entry->offset)) {
     last_sub_batch_offset = last_entry_offset;
     sub_batch_cnt++;
@@ -122,24 +155,40 @@ bool WriteBatchWithIndex::Rep::UpdateExistingEntryWithCfId(
 
 void WriteBatchWithIndex::Rep::AddOrUpdateIndex(
     ColumnFamilyHandle* column_family, const Slice& key, WriteType type) {
-  if (!UpdateExistingEntry(column_family, key, type)) {
+  if (defer_indexing || !UpdateExistingEntry(column_family, key, type)) {
     uint32_t cf_id = GetColumnFamilyID(column_family);
     const auto* cf_cmp = GetColumnFamilyUserComparator(column_family);
     if (cf_cmp != nullptr) {
       comparator.SetComparatorForCF(cf_id, cf_cmp);
     }
-    AddNewEntry(cf_id);
+    if (defer_indexing) {
+      deferred_entries.push_back({NewIndexEntry(cf_id), type});
+    } else {
+      AddNewEntry(cf_id);
+    }
   }
 }
 
 void WriteBatchWithIndex::Rep::AddOrUpdateIndex(const Slice& key,
                                                 WriteType type) {
-  if (!UpdateExistingEntryWithCfId(0, key, type)) {
-    AddNewEntry(0);
+  AddOrUpdateIndexWithCfId(0, key, type);
+}
+
+void WriteBatchWithIndex::Rep::AddOrUpdateIndexWithCfId(
+    uint32_t column_family_id, const Slice& key, WriteType type) {
+  if (defer_indexing) {
+    deferred_entries.push_back({NewIndexEntry(column_family_id), type});
+  } else if (!UpdateExistingEntryWithCfId(column_family_id, key, type)) {
+    AddNewEntry(column_family_id);
   }
 }
 
 void WriteBatchWithIndex::Rep::AddNewEntry(uint32_t column_family_id) {
+  skip_list.Insert(NewIndexEntry(column_family_id));
+}
+
+WriteBatchIndexEntry* WriteBatchWithIndex::Rep::NewIndexEntry(
+    uint32_t column_family_id) {
   const std::string& wb_data = write_batch.Data();
   Slice entry_ptr = Slice(wb_data.data() + last_entry_offset,
                           wb_data.size() - last_entry_offset);
@@ -160,18 +209,86 @@ void WriteBatchWithIndex::Rep::AddNewEntry(uint32_t column_family_id) {
   }
 
   auto* mem = arena.Allocate(sizeof(WriteBatchIndexEntry));
-  auto* index_entry =
-      new (mem) WriteBatchIndexEntry(last_entry_offset, column_family_id,
-                                     key.data() - wb_data.data(), key.size());
-  skip_list.Insert(index_entry);
+  return new (mem) WriteBatchIndexEntry(last_entry_offset, column_family_id,
+                                        key.data() - wb_data.data(),
+                                        key.size());
+}
+
+void WriteBatchWithIndex::Rep::IndexDeferredEntries() {
+  if (!defer_indexing) {
+    return;
+  }
+  defer_indexing = false;
+  if (deferred_entries.empty()) {
+    return;
+  }
+
+  // Entries of the same key end up next to each other in write order, as
+  // the comparator orders them by offset.
+  std::vector<DeferredEntry> sorted(std::move(deferred_entries));
+  deferred_entries.clear();
+  std::sort(sorted.begin(), sorted.end(),
+            [this](const DeferredEntry& a, const DeferredEntry& b) {
+              return comparator(a.entry, b.entry) < 0;
+            });
+
+  bool index_empty;
+  {
+    WriteBatchEntrySkipList::Iterator iter(&skip_list);
+    iter.SeekToFirst();
+    index_empty = !iter.Valid();
+  }
+
+  // (offset, offset of the previous update of the same key) for the updates
+  // that had one, to count the sub-batches in write order afterwards
+  std::vector<std::pair<size_t, size_t>> duplicates;
+  const char* data = write_batch.Data().data();
+  size_t i = 0;
+  while (i < sorted.size()) {
+    WriteBatchIndexEntry* first = sorted[i].entry;
+    const Slice key(data + first->key_offset, first->key_size);
+    WriteBatchIndexEntry* last = nullptr;
+    if (overwrite_key && !index_empty) {
+      last = FindLastEntry(first->column_family, key);
+    }
+    for (; i < sorted.size(); i++) {
+      WriteBatchIndexEntry* entry = sorted[i].entry;
+      if (entry != first &&
+          (entry->column_family != first->column_family ||
+           comparator.CompareKey(first->column_family, key,
+                                 Slice(data + entry->key_offset,
+                                       entry->key_size)) != 0)) {
+        break;
+      }
+      if (overwrite_key && last != nullptr) {
+        duplicates.emplace_back(entry->offset, last->offset);
+        if (sorted[i].type != kMergeRecord) {
+          last->offset = entry->offset;
+          continue;
+        }
+      }
+      skip_list.Insert(entry);
+      last = entry;
+    }
+  }
+
+  std::sort(duplicates.begin(), duplicates.end());
+  for (const auto& dup : duplicates) {
+    if (last_sub_batch_offset <= dup.second) {
+      last_sub_batch_offset = dup.first;
+      sub_batch_cnt++;
+    }
+  }
 }
 
 void WriteBatchWithIndex::Rep::Clear() {
   write_batch.Clear();
   ClearIndex();
+  defer_indexing = lazy_indexing;
 }
 
 void WriteBatchWithIndex::Rep::ClearIndex() {
+  deferred_entries.clear();
   skip_list.~WriteBatchEntrySkipList();
   arena.~Arena();
   new (&arena) Arena();
@@ -216,32 +333,22 @@ Status WriteBatchWithIndex::Rep::ReBuildIndex() {
       case kTypeColumnFamilyValue:
       case kTypeValue:
         found++;
-        if (!UpdateExistingEntryWithCfId(column_family_id, key, kPutRecord)) {
-          AddNewEntry(column_family_id);
-        }
+        AddOrUpdateIndexWithCfId(column_family_id, key, kPutRecord);
         break;
       case kTypeColumnFamilyDeletion:
       case kTypeDeletion:
         found++;
-        if (!UpdateExistingEntryWithCfId(column_family_id, key,
-                                         kDeleteRecord)) {
-          AddNewEntry(column_family_id);
-        }
+        AddOrUpdateIndexWithCfId(column_family_id, key, kDeleteRecord);
         break;
       case kTypeColumnFamilySingleDeletion:
       case kTypeSingleDeletion:
         found++;
-        if (!UpdateExistingEntryWithCfId(column_family_id, key,
-                                         kSingleDeleteRecord)) {
-          AddNewEntry(column_family_id);
-        }
+        AddOrUpdateIndexWithCfId(column_family_id, key, kSingleDeleteRecord);
         break;
       case kTypeColumnFamilyMerge:
       case kTypeMerge:
         found++;
-        if (!UpdateExistingEntryWithCfId(column_family_id, key, kMergeRecord)) {
-          AddNewEntry(column_family_id);
-        }
+        AddOrUpdateIndexWithCfId(column_family_id, key, kMergeRecord);
         break;
       case kTypeLogData:
       case kTypeBeginPrepareXID:
@@ -282,15 +389,20 @@ WriteBatchWithIndex& WriteBatchWithIndex::operator=(WriteBatchWithIndex&&) =
 
 WriteBatch* WriteBatchWithIndex::GetWriteBatch() { return &rep->write_batch; }
 
-size_t WriteBatchWithIndex::SubBatchCnt() { return rep->sub_batch_cnt; }
+size_t WriteBatchWithIndex::SubBatchCnt() {
+  rep->IndexDeferredEntries();
+  return rep->sub_batch_cnt;
+}
 
 WBWIIterator* WriteBatchWithIndex::NewIterator() {
+  rep->IndexDeferredEntries();
   return new WBWIIteratorImpl(0, &(rep->skip_list), &rep->write_batch,
                               &(rep->comparator));
 }
 
 WBWIIterator* WriteBatchWithIndex::NewIterator(
     ColumnFamilyHandle* column_family) {
+  rep->IndexDeferredEntries();
   return new WBWIIteratorImpl(GetColumnFamilyID(column_family),
                               &(rep->skip_list), &rep->write_batch,
                               &(rep->comparator));
@@ -299,6 +411,7 @@ WBWIIterator* WriteBatchWithIndex::NewIterator(
 Iterator* WriteBatchWithIndex::NewIteratorWithBase(
     ColumnFamilyHandle* column_family, Iterator* base_iterator,
     const ReadOptions* read_options) {
+  rep->IndexDeferredEntries();
   auto wbwiii =
       new WBWIIteratorImpl(GetColumnFamilyID(column_family), &(rep->skip_list),
                            &rep->write_batch, &rep->comparator);
@@ -308,6 +421,7 @@ Iterator* WriteBatchWithIndex::NewIteratorWithBase(
 }
 
 Iterator* WriteBatchWithIndex::NewIteratorWithBase(Iterator* base_iterator) {
+  rep->IndexDeferredEntries();
   // default column family's comparator
   auto wbwiii = new WBWIIteratorImpl(0, &(rep->skip_list), &rep->write_batch,
                                      &rep->comparator);
@@ -681,6 +795,15 @@ void WriteBatchWithIndex::SetMaxBytes(size_t max_bytes) {
   rep->write_batch.SetMaxBytes(max_bytes);
 }
 
+void WriteBatchWithIndex::SetLazyIndexing(bool lazy_indexing) {
+  rep->lazy_indexing = lazy_indexing;
+  if (lazy_indexing) {
+    rep->defer_indexing = true;
+  } else {
+    rep->IndexDeferredEntries();
+  }
+}
+
 size_t WriteBatchWithIndex::GetDataSize() const {
   return rep->write_batch.GetDataSize();
 }
@@ -2398,6 +2398,98 @@ TEST_P(WriteBatchWithIndexTest, IndexNoTs) {
   }
 }
 
+TEST_P(WriteBatchWithIndexTest, LazyIndexing) {
+  ColumnFamilyHandleImplDummy cf1(6, BytewiseComparator());
+  ColumnFamilyHandleImplDummy cf2(2, ReverseBytewiseComparator());
+  WriteBatchWithIndex lazy(BytewiseComparator(), 20, GetParam());
+  lazy.SetLazyIndexing(true);
+
+  // GetFromBatch() cannot resolve merges on the dummy column families, so
+  // the rounds with merges only compare the contents of the batches.
+  bool with_merge = false;
+  Random rnd(301);
+  auto write_random = [&](int count) {
+    for (int i = 0; i < count; i++) {
+      ColumnFamilyHandle* cf = rnd.OneIn(2) ? &cf1 : &cf2;
+      std::string key = "k" + std::to_string(rnd.Uniform(20));
+      std::string value = "v" + std::to_string(i);
+      uint32_t op = rnd.Uniform(4);
+      if (op == 1 && !with_merge) {
+        op = 0;
+      }
+      switch (op) {
+        case 0:
+          ASSERT_OK(batch_->Put(cf, key, value));
+          ASSERT_OK(lazy.Put(cf, key, value));
+          break;
+        case 1:
+          ASSERT_OK(batch_->Merge(cf, key, value));
+          ASSERT_OK(lazy.Merge(cf, key, value));
+          break;
+        case 2:
+          ASSERT_OK(batch_->Delete(cf, key));
+          ASSERT_OK(lazy.Delete(cf, key));
+          break;
+        default:
+          ASSERT_OK(batch_->SingleDelete(cf, key));
+          ASSERT_OK(lazy.SingleDelete(cf, key));
+          break;
+      }
+    }
+  };
+  auto assert_same = [&]() {
+    ASSERT_EQ(PrintContents(batch_.get(), &cf1),
+              PrintContents(&lazy, &cf1));
+    ASSERT_EQ(PrintContents(batch_.get(), &cf2),
+              PrintContents(&lazy, &cf2));
+    if (with_merge) {
+      return;
+    }
+    for (int i = 0; i < 20; i++) {
+      std::string key = "k" + std::to_string(i);
+      std::string expected, actual;
+      Status expected_s = batch_->GetFromBatch(&cf1, options_, key, &expected);
+      Status actual_s = lazy.GetFromBatch(&cf1, options_, key, &actual);
+      ASSERT_EQ(expected_s.code(), actual_s.code());
+      ASSERT_EQ(expected, actual);
+    }
+  };
+
+  for (int round = 0; round < 4; round++) {
+    with_merge = round % 2 == 1;
+
+    // All writes deferred, indexed by the first read
+    write_random(200);
+    assert_same();
+
+    // Indexed directly after the first read
+    write_random(50);
+    assert_same();
+
+    // Rebuilding the index after a rollback defers it again
+    batch_->Clear();
+    lazy.Clear();
+    write_random(100);
+    batch_->SetSavePoint();
+    lazy.SetSavePoint();
+    write_random(100);
+    ASSERT_OK(batch_->RollbackToSavePoint());
+    ASSERT_OK(lazy.RollbackToSavePoint());
+    write_random(100);
+    assert_same();
+
+    batch_->Clear();
+    lazy.Clear();
+  }
+
+  // Disabling lazy indexing indexes the pending writes
+  with_merge = false;
+  write_random(100);
+  lazy.SetLazyIndexing(false);
+  write_random(100);
+  assert_same();
+}
+
 INSTANTIATE_TEST_CASE_P(WBWI, WriteBatchWithIndexTest, testing::Bool());
 }  // namespace ROCKSDB_NAMESPACE
 